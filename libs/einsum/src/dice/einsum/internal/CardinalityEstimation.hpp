@@ -7,8 +7,11 @@
 
 #include <dice/hypertrie/Hypertrie.hpp>
 
+#include <boost/container/small_vector.hpp>
 #include <robin_hood.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 
 namespace dice::einsum::internal {
@@ -91,22 +94,23 @@ namespace dice::einsum::internal {
 							   std::shared_ptr<Subscript> const &sc) {
 			// get operands that have the label
 			std::vector<LabelPos> const &op_poss = sc->getPossOfOperandsWithLabel(label);
-			std::vector<double> op_dim_cardinalities(op_poss.size(), 1.0);
-			auto label_count = 0;
+			// the buffers stay on the stack unless the label occurs in many operands
+			::boost::container::small_vector<double, 8> op_dim_cardinalities(op_poss.size(), 1.0);
+			::boost::container::small_vector<size_t, 16> sizes{};
+			std::array<size_t, htt_t::max_depth> op_dim_cards_buffer;
 			auto min_dim_card = std::numeric_limits<size_t>::max();
-			::robin_hood::unordered_set<size_t> sizes{};
 			const LabelPossInOperands &label_poss_in_operands = sc->getLabelPossInOperands(label);
 			// iterate the operands that hold the label
 			for (size_t i = 0; i < op_poss.size(); ++i) {
 				auto const &op_pos = op_poss[i];
 				auto const &operand = operands[op_pos];
-				auto const op_dim_cards = operand.get_cards(label_poss_in_operands[op_pos]);
-				auto const min_op_dim_card = *std::min_element(op_dim_cards.cbegin(), op_dim_cards.cend());
-				auto const max_op_dim_card = *std::max_element(op_dim_cards.cbegin(), op_dim_cards.cend());
-				for (const auto &op_dim_card : op_dim_cards) {
-					sizes.insert(op_dim_card);
+				auto const op_dim_cards = operand.get_cards(label_poss_in_operands[op_pos], op_dim_cards_buffer);
+				auto const [min_op_dim_card, max_op_dim_card] = std::ranges::minmax(op_dim_cards);
+				for (auto const op_dim_card : op_dim_cards) {
+					if (std::ranges::find(sizes, op_dim_card) == sizes.end()) {
+						sizes.push_back(op_dim_card);
+					}
 				}
-				label_count += op_dim_cards.size();
 				// update minimal dimension cardinality
 				if (min_op_dim_card < min_dim_card) {
 					min_dim_card = min_op_dim_card;
@@ -4,6 +4,8 @@
 #include "dice/hypertrie/Hypertrie.hpp"
 #include "dice/hypertrie/BulkUpdater.hpp"
 #include "dice/hypertrie/HashJoin.hpp"
+#include "dice/hypertrie/HypertrieSnapshot.hpp"
+#include "dice/hypertrie/StaticHypertrie.hpp"
 #include "dice/hypertrie/Hypertrie_version.hpp"
 
 #include "dice/hypertrie/Hypertrie_default_traits.hpp"
@@ -3,20 +3,24 @@
 
 #include "dice/hypertrie/BulkUpdater_predeclare.hpp"
 #include "dice/hypertrie/Hypertrie.hpp"
+#include "dice/hypertrie/HypertrieSnapshot.hpp"
 #include "dice/hypertrie/internal/raw/node_context/BulkUpdaterSettings.hpp"
 #include "dice/hypertrie/internal/raw/node_context/RawBulkUpdater.hpp"
 #include "dice/hypertrie/internal/raw/node_context/SynchronousRawBulkUpdater.hpp"
 
+#include <span>
+
 namespace dice::hypertrie {
 	namespace bulk_updater_detail {
-		template<BulkUpdaterMode mode, HypertrieTrait_bool_valued htt_t, ByteAllocator allocator_type, size_t depth, BulkUpdaterSyncness syncness>
+		template<BulkUpdaterMode mode, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t depth, BulkUpdaterSyncness syncness>
 		using RawBulkUpdater_tt = std::conditional_t<syncness == BulkUpdaterSyncness::Async,
-													 internal::raw::RawHypertrieBulkUpdater<mode, depth, htt_t, allocator_type, hypertrie_max_depth>,
-													 internal::raw::SynchronousRawHypertrieBulkUpdater<mode, depth, htt_t, allocator_type, hypertrie_max_depth>>;
+													 internal::raw::RawHypertrieBulkUpdater<mode, depth, htt_t, allocator_type, htt_t::max_depth>,
+													 internal::raw::SynchronousRawHypertrieBulkUpdater<mode, depth, htt_t, allocator_type, htt_t::max_depth>>;
 	}
 
-	template<BulkUpdaterMode mode, HypertrieTrait_bool_valued htt_t, ByteAllocator allocator_type, BulkUpdaterSyncness syncness>
-	class alignas(bulk_updater_detail::RawBulkUpdater_tt<mode, htt_t, allocator_type, hypertrie_max_depth, syncness>) BulkUpdater {
+	template<BulkUpdaterMode mode, HypertrieTrait htt_t, ByteAllocator allocator_type, BulkUpdaterSyncness syncness>
+		requires internal::raw::BulkUpdaterModeSupported<mode, htt_t>
+	class alignas(bulk_updater_detail::RawBulkUpdater_tt<mode, htt_t, allocator_type, htt_t::max_depth, syncness>) BulkUpdater {
 	public:
 		using Entry = NonZeroEntry<htt_t>;
 		template<size_t depth>
@@ -29,20 +33,24 @@ namespace dice::hypertrie {
 		template<size_t depth>
 		using RawBulkUpdater_t = bulk_updater_detail::RawBulkUpdater_tt<mode, htt_t, allocator_type, depth, syncness>;
 
-		using max_sized_RawBulkUpdater_t = RawBulkUpdater_t<hypertrie_max_depth>;
+		using max_sized_RawBulkUpdater_t = RawBulkUpdater_t<htt_t::max_depth>;
 
 		/**
 		 * Struct with functions of a RawHypertrieBulkUpdater with fixed depth. This translates the parameter "depth of a hypertrie" from runtime (BulkUpdater) to compile time (RawHypertrieBulkUpdater).
 		 */
 		struct RawMethods {
 			/**
-			  * Constructs an RawHypertrieBulkUpdater for hypertrie at the memory address voided_bulk_updater. Parameters bulk_size and bulk_processed_callback are passed to the constructor.
+			  * Constructs an RawHypertrieBulkUpdater for hypertrie at the memory address voided_bulk_updater. Parameters bulk_size, bulk_processed_callback, workers, snapshots, producers and backoff are passed to the constructor.
 			  * @param hypertrie
 			  * @param voided_bulk_updater
 			  * @param bulk_size
 			  * @param bulk_processed_callback
+			  * @param workers
+			  * @param snapshots
+			  * @param producers
+			  * @param backoff
 			  */
-			void (*const construct)(Hypertrie<htt_t, allocator_type> &hypertrie, void *voided_bulk_updater, uint32_t bulk_size, BulkProcessed_callback bulk_processed_callback);
+			void (*const construct)(Hypertrie<htt_t, allocator_type> &hypertrie, void *voided_bulk_updater, uint32_t bulk_size, BulkProcessed_callback bulk_processed_callback, size_t workers, SnapshotManager<htt_t, allocator_type> *snapshots, size_t producers, BulkUpdaterBackoff backoff);
 			/**
 			 * Calls the destructor of a RawHypertrieBulkUpdater located at voided_bulk_updater.
 			 * @param voided_bulk_updater
@@ -52,14 +60,31 @@ namespace dice::hypertrie {
 			  * Adds the RawEntry located at raw_entry to the RawHypertrieBulkUpdater located at voided_bulk_updater.
 			  * @param voided_bulk_updater
 			  * @param raw_entry
+			  * @param producer
 			  */
-			void (*const add_raw)(void *voided_bulk_updater, void const *raw_entry);
+			void (*const add_raw)(void *voided_bulk_updater, void const *raw_entry, size_t producer);
 			/**
 			 * Adds entry to the RawHypertrieBulkUpdater located at voided_bulk_updater.
 			 * @param voided_bulk_updater
 			 * @param entry
+			 * @param producer
+			 */
+			void (*const add)(void *voided_bulk_updater, Entry const& entry, size_t producer);
+			/**
+			 * Adds the count RawEntries starting at raw_entries to the RawHypertrieBulkUpdater located at voided_bulk_updater.
+			 * @param voided_bulk_updater
+			 * @param raw_entries
+			 * @param count
+			 * @param producer
+			 */
+			void (*const add_batch_raw)(void *voided_bulk_updater, void const *raw_entries, size_t count, size_t producer);
+			/**
+			 * Adds entries to the RawHypertrieBulkUpdater located at voided_bulk_updater.
+			 * @param voided_bulk_updater
+			 * @param entries
+			 * @param producer
 			 */
-			void (*const add)(void *voided_bulk_updater, Entry const& entry);
+			void (*const add_batch)(void *voided_bulk_updater, std::span<Entry const> entries, size_t producer);
 			/**
 			 * Returns the number of entries which are currently queued to be inserted into/removed from the hypertrie at the RawHypertrieBulkUpdater located at voided_bulk_updater.
 			 * @param voided_bulk_updater
@@ -78,22 +103,37 @@ namespace dice::hypertrie {
 				using RawBulkUpdater_tt = RawBulkUpdater_t<depth>;
 				using RawEntry_t = RawEntry<depth>;
 				return {
-						.construct = [](Hypertrie<htt_t, allocator_type> &hypertrie, void *voided_bulk_updater, uint32_t bulk_size, BulkProcessed_callback bulk_processed_callback) {
+						.construct = [](Hypertrie<htt_t, allocator_type> &hypertrie, void *voided_bulk_updater, uint32_t bulk_size, BulkProcessed_callback bulk_processed_callback, size_t workers, SnapshotManager<htt_t, allocator_type> *snapshots, size_t producers, BulkUpdaterBackoff backoff) {
+						internal::raw::SnapshotRegistry<htt_t::max_depth, htt_t, allocator_type> *snapshot_registry = nullptr;
+						if constexpr (htt_t::node_storage_shards > 1) {
+							if (snapshots != nullptr)
+								snapshot_registry = &snapshots->raw_registry();
+						}
 						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
 						std::construct_at(reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater),
 										  hypertrie.node_container_,
 										  hypertrie.context()->raw_context(),
 										  bulk_size,
-										  bulk_processed_callback); },
+										  bulk_processed_callback,
+										  workers,
+										  snapshot_registry,
+										  producers,
+										  backoff); },
 						.destroy = [](void *voided_bulk_updater) {
 						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
 						std::destroy_at(reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater)); },
-						.add_raw = [](void *voided_bulk_updater, void const *raw_entry) {
+						.add_raw = [](void *voided_bulk_updater, void const *raw_entry, size_t producer) {
+						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+						reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater)->add(*reinterpret_cast<RawEntry_t const *>(raw_entry), producer); },
+						.add = [](void *voided_bulk_updater, Entry const &entry, size_t producer) {
+						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+						reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater)->add(entry, producer); },
+						.add_batch_raw = [](void *voided_bulk_updater, void const *raw_entries, size_t count, size_t producer) {
 						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-						reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater)->add(*reinterpret_cast<RawEntry_t const *>(raw_entry)); },
-						.add = [](void *voided_bulk_updater, Entry const &entry) {
+						reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater)->add_batch(std::span<RawEntry_t const>{reinterpret_cast<RawEntry_t const *>(raw_entries), count}, producer); },
+						.add_batch = [](void *voided_bulk_updater, std::span<Entry const> entries, size_t producer) {
 						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
-						reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater)->add(entry); },
+						reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater)->add_batch(entries, producer); },
 						.size = [](void const *voided_bulk_updater) noexcept {
 						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
 						return reinterpret_cast<RawBulkUpdater_tt const *>(voided_bulk_updater)->size(); },
@@ -102,14 +142,14 @@ namespace dice::hypertrie {
 						reinterpret_cast<RawBulkUpdater_tt *>(voided_bulk_updater)->flush(); }};
 			};
 
-			using RawMethodsCache = std::array<RawMethods const, hypertrie_max_depth>;
+			using RawMethodsCache = std::array<RawMethods const, htt_t::max_depth>;
 
 			template<typename std::size_t... IDs>
 			static RawMethodsCache get_raw_methods(std::index_sequence<IDs...>) {
 				return {RawMethods::instance<IDs + 1>()...};
 			}
 			static RawMethodsCache const &get_raw_methods() {
-				static RawMethodsCache raw_methods{get_raw_methods(std::make_index_sequence<hypertrie_max_depth>{})};
+				static RawMethodsCache raw_methods{get_raw_methods(std::make_index_sequence<htt_t::max_depth>{})};
 				return raw_methods;
 			}
 
@@ -117,7 +157,7 @@ namespace dice::hypertrie {
 			/**
 			 * Get a populated instance for the given depth.
 			 * @param depth depth of the hypertrie into which entries are inserted/removed
-			 * @return struct with functionpointers to RawHypertrieBulkUpdater<depth, htt_t, hypertrie_max_depth> member functions.
+			 * @return struct with functionpointers to RawHypertrieBulkUpdater<depth, htt_t, htt_t::max_depth> member functions.
 			 */
 			static RawMethods const &instance(size_t depth) {
 				return get_raw_methods()[depth - 1];
@@ -136,15 +176,28 @@ namespace dice::hypertrie {
 		BulkUpdater & operator=(BulkUpdater const&) = delete;
 		BulkUpdater & operator=(BulkUpdater &&) = delete;
 
+		/**
+		 * @param hypertrie hypertrie to be updated
+		 * @param bulk_size number of entries that are collected before they are applied to the hypertrie
+		 * @param bulk_processed_callback called after each bulk was applied
+		 * @param workers maximum number of threads used to apply a bulk to the hypertrie. With 1, a bulk is applied by a single thread.
+		 * @param snapshots if not nullptr, each bulk is published as a whole to the snapshot readers of hypertrie (see SnapshotManager::publish)
+		 * @param producers number of threads that may add entries concurrently. Each thread passes its own producer index in [0, producers) to add and add_batch.
+		 * @param backoff how the threads of an asynchronous bulk updater wait for each other, e.g. when the queue is full or the bulk is applied. Use BulkUpdaterBackoff::busy_wait() to never give up the CPU.
+		 */
 		explicit BulkUpdater(
 				Hypertrie<htt_t, allocator_type> &hypertrie,
 				uint32_t bulk_size = 1'000'000U,
 				BulkProcessed_callback bulk_processed_callback = []([[maybe_unused]] size_t processed_entries,
 																  [[maybe_unused]] size_t committed_entries,
-																  [[maybe_unused]] size_t hypertrie_size_after) noexcept {})
+																  [[maybe_unused]] size_t hypertrie_size_after) noexcept {},
+				size_t workers = 1,
+				SnapshotManager<htt_t, allocator_type> *snapshots = nullptr,
+				size_t producers = 1,
+				BulkUpdaterBackoff backoff = {})
 			: raw_methods(&RawMethods::instance(hypertrie.depth())),
 			  depth_(hypertrie.depth()) {
-			raw_methods->construct(hypertrie, &raw_bulk_updater, bulk_size, bulk_processed_callback);
+			raw_methods->construct(hypertrie, &raw_bulk_updater, bulk_size, bulk_processed_callback, workers, snapshots, producers, backoff);
 		}
 
 		BulkUpdater(Hypertrie<htt_t, allocator_type> const &) = delete;
@@ -155,16 +208,38 @@ namespace dice::hypertrie {
 			raw_methods = nullptr;
 		}
 
+		/**
+		 * @param entry entry to be added
+		 * @param producer index of the calling producer
+		 */
+		template<size_t depth>
+		void add(RawEntry<depth> const &entry, size_t producer = 0) {
+			if (depth_ == depth) [[likely]]
+				raw_methods->add_raw(&raw_bulk_updater, &entry, producer);
+			else [[unlikely]]
+				throw std::logic_error{"Entry has wrong depth."};
+		}
+
+		void add(Entry const &entry, size_t producer = 0) {
+			raw_methods->add(&raw_bulk_updater, entry, producer);
+		}
+
+		/**
+		 * Adds multiple entries. This is cheaper than adding them one by one because the synchronization with the
+		 * thread that applies the bulks is done for many entries at once.
+		 * @param entries entries to be added
+		 * @param producer index of the calling producer
+		 */
 		template<size_t depth>
-		void add(RawEntry<depth> const &entry) {
+		void add_batch(std::span<RawEntry<depth> const> entries, size_t producer = 0) {
 			if (depth_ == depth) [[likely]]
-				raw_methods->add_raw(&raw_bulk_updater, &entry);
+				raw_methods->add_batch_raw(&raw_bulk_updater, entries.data(), entries.size(), producer);
 			else [[unlikely]]
 				throw std::logic_error{"Entry has wrong depth."};
 		}
 
-		void add(Entry const &entry) {
-			raw_methods->add(&raw_bulk_updater, entry);
+		void add_batch(std::span<Entry const> entries, size_t producer = 0) {
+			raw_methods->add_batch(&raw_bulk_updater, entries, producer);
 		}
 
 		[[nodiscard]] size_t size() const noexcept {
@@ -9,15 +9,17 @@ namespace dice::hypertrie {
 
 	using internal::raw::BulkUpdaterMode;
 	using internal::raw::BulkUpdaterSyncness;
+	using internal::raw::BulkUpdaterBackoff;
 
 	/**
 	 * Bulk updater for a hypertrie.
-	 * @tparam mode if inserting or deleting entries
-	 * @tparam tr_t Hypertrie trait that must be boolean valued.
+	 * @tparam mode if inserting or deleting entries (Boolean valued hypertries) or if setting or adding values (non-Boolean valued hypertries)
+	 * @tparam tr_t Hypertrie trait that must support mode (see BulkUpdaterModeSupported).
 	 * @tparam allocator_type The allocator used by the hypertrie.
 	 * @tparam syncness If queueing entries for insertion and executing the insertion happen on the same thread.
 	 */
-	template<BulkUpdaterMode mode, HypertrieTrait_bool_valued tr_t, ByteAllocator allocator_type, BulkUpdaterSyncness syncness>
+	template<BulkUpdaterMode mode, HypertrieTrait tr_t, ByteAllocator allocator_type, BulkUpdaterSyncness syncness>
+		requires internal::raw::BulkUpdaterModeSupported<mode, tr_t>
 	class BulkUpdater;
 
 	template<HypertrieTrait_bool_valued tr_t, ByteAllocator allocator_type, BulkUpdaterSyncness syncness>
@@ -38,6 +40,30 @@ namespace dice::hypertrie {
 	template<HypertrieTrait_bool_valued tr_t, ByteAllocator allocator_type>
 	using AsyncBulkRemover = BulkRemover<tr_t, allocator_type, BulkUpdaterSyncness::Async>;
 
+	template<HypertrieTrait tr_t, ByteAllocator allocator_type, BulkUpdaterSyncness syncness>
+		requires(not tr_t::is_bool_valued)
+	using BulkSetter = BulkUpdater<BulkUpdaterMode::Set, tr_t, allocator_type, syncness>;
+
+	template<HypertrieTrait tr_t, ByteAllocator allocator_type, BulkUpdaterSyncness syncness>
+		requires(not tr_t::is_bool_valued)
+	using BulkAdder = BulkUpdater<BulkUpdaterMode::Add, tr_t, allocator_type, syncness>;
+
+	template<HypertrieTrait tr_t, ByteAllocator allocator_type>
+		requires(not tr_t::is_bool_valued)
+	using SyncBulkSetter = BulkSetter<tr_t, allocator_type, BulkUpdaterSyncness::Sync>;
+
+	template<HypertrieTrait tr_t, ByteAllocator allocator_type>
+		requires(not tr_t::is_bool_valued)
+	using AsyncBulkSetter = BulkSetter<tr_t, allocator_type, BulkUpdaterSyncness::Async>;
+
+	template<HypertrieTrait tr_t, ByteAllocator allocator_type>
+		requires(not tr_t::is_bool_valued)
+	using SyncBulkAdder = BulkAdder<tr_t, allocator_type, BulkUpdaterSyncness::Sync>;
+
+	template<HypertrieTrait tr_t, ByteAllocator allocator_type>
+		requires(not tr_t::is_bool_valued)
+	using AsyncBulkAdder = BulkAdder<tr_t, allocator_type, BulkUpdaterSyncness::Async>;
+
 }// namespace dice::hypertrie
 
 
@@ -25,14 +25,14 @@ namespace dice::hypertrie {
 	public:
 		using key_part_type = typename htt_t::key_part_type;
 		using value_type = typename htt_t::value_type;
-		using RawKeyPositions_t = internal::raw::RawKeyPositions<hypertrie_max_depth>;
+		using RawKeyPositions_t = internal::raw::RawKeyPositions<htt_t::max_depth>;
 
 	private:
 		template<size_t diag_depth, size_t depth, template<size_t, typename, typename> typename node_type>
-		using RawHashDiagonal_t = typename internal::raw::template RawHashDiagonal<diag_depth, depth, node_type, htt_t, allocator_type, hypertrie_max_depth>;
-		using max_sized_RawHashDiagonal_t = std::conditional_t<(sizeof(RawHashDiagonal_t<1, hypertrie_max_depth, internal::raw::FullNode>) > sizeof(RawHashDiagonal_t<1, hypertrie_max_depth, internal::raw::SingleEntryNode>)),
-															   RawHashDiagonal_t<1, hypertrie_max_depth, internal::raw::FullNode>,
-															   RawHashDiagonal_t<1, hypertrie_max_depth, internal::raw::SingleEntryNode>>;
+		using RawHashDiagonal_t = typename internal::raw::template RawHashDiagonal<diag_depth, depth, node_type, htt_t, allocator_type, htt_t::max_depth>;
+		using max_sized_RawHashDiagonal_t = std::conditional_t<(sizeof(RawHashDiagonal_t<1, htt_t::max_depth, internal::raw::FullNode>) > sizeof(RawHashDiagonal_t<1, htt_t::max_depth, internal::raw::SingleEntryNode>)),
+															   RawHashDiagonal_t<1, htt_t::max_depth, internal::raw::FullNode>,
+															   RawHashDiagonal_t<1, htt_t::max_depth, internal::raw::SingleEntryNode>>;
 
 	protected:
 		struct RawMethods {
@@ -73,11 +73,11 @@ namespace dice::hypertrie {
 			static_assert(not(is_fn and not uses_provided_alloc));
 
 			using used_alloc = std::conditional_t<(uses_provided_alloc), allocator_type, std::allocator<std::byte>>;
-			using RawDiagonalHash_tt = RawHashDiagonal<diag_depth, depth, node_type, htt_t, used_alloc, hypertrie_max_depth>;
+			using RawDiagonalHash_tt = RawHashDiagonal<diag_depth, depth, node_type, htt_t, used_alloc, htt_t::max_depth>;
 			return RawMethods{
 					.construct =
 							[](const_Hypertrie<htt_t, allocator_type> const &hypertrie, RawKeyPositions_t const &diagonal_poss, void *raw_diagonal_ptr) noexcept {
-								auto &raw_diag_poss = unsafe_cast<RawKeyPositions<depth> const>(diagonal_poss);
+								RawKeyPositions<depth> const raw_diag_poss{diagonal_poss};
 								if constexpr (is_fn) {
 									FNContainer<depth, htt_t, used_alloc> nodec{hypertrie.template node_container<depth>()};
 									// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
@@ -185,16 +185,16 @@ namespace dice::hypertrie {
 			using namespace ::dice::hypertrie::internal::raw;
 			using namespace ::dice::hypertrie::internal::util;
 			RawMethosCache raw_methods;
-			// depth = 1 ... hypertrie_max_depth
+			// depth = 1 ... htt_t::max_depth
 			// diag_depth = 1 ... depth
 			// tuple = <FullNode<..., allocator_type>, SingleEntryNode<..., allocator_type>, SingleEntryNode<..., std::allocator<std::byte>>>
-			raw_methods.resize(hypertrie_max_depth);
-			for (size_t depth = 1; depth < hypertrie_max_depth + 1; ++depth) {
+			raw_methods.resize(htt_t::max_depth);
+			for (size_t depth = 1; depth < htt_t::max_depth + 1; ++depth) {
 				auto &raw_methods_with_depth = raw_methods[depth - 1];
 				raw_methods_with_depth.resize(depth);
 				for (size_t diag_depth = 1; diag_depth < depth + 1; ++diag_depth) {
 					raw_methods_with_depth[diag_depth - 1] =
-							template_library::switch_cases<1UL, hypertrie_max_depth + 1>(
+							template_library::switch_cases<1UL, htt_t::max_depth + 1>(
 									depth,
 									[&](auto depth_arg) -> std::tuple<RawMethods, RawMethods, RawMethods> {//
 										return template_library::switch_cases<1UL, depth_arg + 1>(
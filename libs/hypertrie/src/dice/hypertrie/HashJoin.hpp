@@ -60,7 +60,7 @@ namespace dice::hypertrie {
 					const auto &join_poss = join.positions_[pos];
 					const auto &hypertrie = join.hypertries_[pos];
 					if (size(join_poss) > 0) {
-						ops_.emplace_back(hypertrie, internal::raw::RawKeyPositions<hypertrie_max_depth>(join_poss));
+						ops_.emplace_back(hypertrie, internal::raw::RawKeyPositions<htt_t::max_depth>(join_poss));
 						auto result_depth = result_depths_.emplace_back(hypertrie.depth() - size(join_poss));
 						if (result_depth) {
 							pos_in_out_.push_back(out_pos++);
@@ -201,7 +201,7 @@ namespace dice::hypertrie {
 					const auto &join_poss = join.positions_[pos];
 					const auto &hypertrie = join.hypertries_[pos];
 					if (size(join_poss) > 0) {
-						ops_.emplace_back(hypertrie, internal::raw::RawKeyPositions<hypertrie_max_depth>(join_poss));
+						ops_.emplace_back(hypertrie, internal::raw::RawKeyPositions<htt_t::max_depth>(join_poss));
 						if (std::find(join.non_optional_positions_.begin(), join.non_optional_positions_.end(), pos) !=
 							join.non_optional_positions_.end())
 							ops_non_optional_positions_.push_back(ops_.size() - 1);
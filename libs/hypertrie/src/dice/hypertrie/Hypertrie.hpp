@@ -11,7 +11,11 @@
 #include "dice/hypertrie/internal/raw/node_context/RawHypertrieContext.hpp"
 #include "dice/template-library/switch_cases.hpp"
 
+#include <algorithm>
+#include <array>
+#include <memory>
 #include <optional>
+#include <span>
 #include <variant>
 #include <vector>
 
@@ -28,25 +32,17 @@ namespace dice::hypertrie {
 
 		friend HashDiagonal<htt_t, allocator_type>;
 		friend Iterator<htt_t, allocator_type>;
-
-		// BulkUpdater types are set to void if htt_t is not boolean valued. Otherwise, const_Hypertrie template would not be instantiatable in such cases.
-		using AsyncBulkInserter = std::conditional_t<HypertrieTrait_bool_valued<htt_t>,
-													 ::dice::hypertrie::AsyncBulkInserter<htt_t, allocator_type>,
-													 void>;
-		using SyncBulkInserter = std::conditional_t<HypertrieTrait_bool_valued<htt_t>,
-													::dice::hypertrie::SyncBulkInserter<htt_t, allocator_type>,
-													void>;
-		using AsyncBulkRemover = std::conditional_t<HypertrieTrait_bool_valued<htt_t>,
-													::dice::hypertrie::AsyncBulkRemover<htt_t, allocator_type>,
-													void>;
-		using SyncBulkRemover = std::conditional_t<HypertrieTrait_bool_valued<htt_t>,
-												   ::dice::hypertrie::SyncBulkRemover<htt_t, allocator_type>,
-												   void>;
-
-		friend AsyncBulkInserter;
-		friend SyncBulkInserter;
-		friend AsyncBulkRemover;
-		friend SyncBulkRemover;
+		friend SnapshotManager<htt_t, allocator_type>;
+		template<size_t, HypertrieTrait, ByteAllocator>
+		friend class const_StaticHypertrie;
+		template<size_t, HypertrieTrait, ByteAllocator>
+		friend class StaticIterator;
+		template<size_t, size_t, HypertrieTrait, ByteAllocator>
+		friend class StaticHashDiagonal;
+
+		template<BulkUpdaterMode mode, HypertrieTrait tr_t, ByteAllocator allocator_type2, BulkUpdaterSyncness syncness>
+			requires internal::raw::BulkUpdaterModeSupported<mode, tr_t>
+		friend class ::dice::hypertrie::BulkUpdater;
 	protected:
 		template<size_t depth>
 		using RawKey_t = internal::raw::RawKey<depth, htt_t>;
@@ -62,6 +58,9 @@ namespace dice::hypertrie {
 		template<size_t depth>
 		using stl_NodeContainer_t = internal::raw::SENContainer<depth, htt_t, std::allocator<std::byte>>;
 
+		template<size_t depth>
+		using stl_SingleEntryNode_t = internal::raw::SingleEntryNode<depth, htt_t, std::allocator<std::byte>>;
+
 		using RawHypertrieContext_t = typename HypertrieContext<htt_t, allocator_type>::RawHypertrieContext_t;
 
 		using HypertrieContext_ptr_t = HypertrieContext_ptr<htt_t, allocator_type>;
@@ -95,12 +94,28 @@ namespace dice::hypertrie {
 		bool managed_ = true;
 		uint32_t depth_ = 0;
 
+		/**
+		 * The SingleEntryNode of a contextless, unmanaged const_Hypertrie (e.g. a slice that resulted in a single entry) is stored here
+		 * instead of on the heap. It has room for a SingleEntryNode of any depth up to htt_t::max_depth.
+		 */
+		alignas(stl_SingleEntryNode_t<htt_t::max_depth>) std::array<std::byte, sizeof(stl_SingleEntryNode_t<htt_t::max_depth>)> inline_sen_;
+
+		template<size_t depth>
+		[[nodiscard]] stl_SingleEntryNode_t<depth> *inline_sen() noexcept {
+			static_assert(sizeof(stl_SingleEntryNode_t<depth>) <= sizeof(inline_sen_));
+			return reinterpret_cast<stl_SingleEntryNode_t<depth> *>(inline_sen_.data());
+		}
+
+		/**
+		 * If the const_Hypertrie is contextless and unmanaged, the SingleEntryNode of node_container is copied to inline_sen_.
+		 * The caller keeps the ownership of the SingleEntryNode it provided.
+		 */
 		const_Hypertrie(size_t depth, HypertrieContext_ptr_t context, bool managed = true, RawNodeContainer_t node_container = {})
 			: node_container_((depth == 0 and node_container.empty()) ? RawNodeContainer_t{{}, nullptr} : node_container),
 			  context_(context),
 			  managed_(managed),
 			  depth_(depth) {
-
+			copy_contextless_node();
 		}
 
 		[[nodiscard]] constexpr bool contextless() const noexcept {
@@ -116,39 +131,44 @@ namespace dice::hypertrie {
 			using namespace internal::raw;
 
 
-			if constexpr (sen_min_depth <= hypertrie_max_depth) {
+			if constexpr (sen_min_depth <= htt_t::max_depth) {
 				if (contextless() and unmanaged() and not node_container_.is_raw_null_ptr() and depth() != 0) {
-					template_library::switch_cases<sen_min_depth, hypertrie_max_depth + 1>(
+					template_library::switch_cases<sen_min_depth, htt_t::max_depth + 1>(
 							this->depth_,
 							[&](auto depth_arg) {
 								// contextless nodes are always SingleEntryNodes
 								assert(this->node_container_.is_sen() and not this->node_container_.empty());
 								using SENContainer_t = SENContainer<depth_arg, htt_t, std::allocator<std::byte>>;
 								SENContainer_t sen_node_container{this->node_container_};
-								// TODO: when we switch over to a pool for SingleEntryNodes, we need to use here AllocateNode::delete_ instead of delete
-								delete sen_node_container.node_ptr();
+								assert(sen_node_container.node_ptr() == this->template inline_sen<depth_arg>());
+								std::destroy_at(sen_node_container.node_ptr());
 							},
 							[]() { assert(false); __builtin_unreachable(); });
 				}
 			}
 		}
 
+		/**
+		 * Copies the SingleEntryNode of a contextless, unmanaged const_Hypertrie, which node_container_ points to, to inline_sen_.
+		 */
 		void copy_contextless_node() noexcept {
 			using namespace internal::util;
 			using namespace internal::raw;
-			if constexpr (sen_min_depth <= hypertrie_max_depth) {
+			if constexpr (sen_min_depth <= htt_t::max_depth) {
 				if (contextless() and unmanaged() and not node_container_.is_raw_null_ptr() and depth() != 0) {
-					template_library::switch_cases<sen_min_depth, hypertrie_max_depth + 1>(
+					template_library::switch_cases<sen_min_depth, htt_t::max_depth + 1>(
 							this->depth_,
 							[&](auto depth_arg) {
 								// contextless nodes are always SingleEntryNodes
 								assert(this->node_container_.is_sen());
 								using SENContainer_t = SENContainer<depth_arg, htt_t, std::allocator<std::byte>>;
-								using SingleEntryNode_t = typename SENContainer_t::Node;
 								SENContainer_t sen_node_container{this->node_container_};
-								// TODO: when we switch over to a pool for SingleEntryNodes, we need to use here AllocateNode::new_ instead of new_
-								sen_node_container.node_ptr(new SingleEntryNode_t(*sen_node_container.node_ptr()));
-								this->node_container_ = sen_node_container;
+								auto *inline_sen = this->template inline_sen<depth_arg>();
+								if (sen_node_container.node_ptr() != inline_sen) {
+									std::construct_at(inline_sen, *sen_node_container.node_ptr());
+									sen_node_container.node_ptr(inline_sen);
+									this->node_container_ = sen_node_container;
+								}
 							},
 							[]() { assert(false);  __builtin_unreachable(); });
 				}
@@ -163,6 +183,8 @@ namespace dice::hypertrie {
 		const_Hypertrie(const_Hypertrie &&other) noexcept
 			: node_container_(other.node_container_), context_(other.context_), managed_(other.managed_), depth_(other.depth_) {
 			assert(this != &other);
+			copy_contextless_node();
+			other.destruct_contextless_node();
 			other.node_container_ = {};
 			other.context_ = {};
 			other.managed_ = true;
@@ -184,10 +206,13 @@ namespace dice::hypertrie {
 
 		const_Hypertrie &operator=(const_Hypertrie &&other) noexcept {
 			assert(this != &other);
+			destruct_contextless_node();
 			this->node_container_ = other.node_container_;
 			this->context_ = other.context_;
 			this->managed_ = other.managed_;
 			this->depth_ = other.depth_;
+			copy_contextless_node();
+			other.destruct_contextless_node();
 			other.context_ = nullptr;
 			other.node_container_ = {};
 			other.managed_ = true;
@@ -227,7 +252,7 @@ namespace dice::hypertrie {
 			if (depth() == 0 or node_container_.is_sen()) {
 				return 1;
 			}
-			return template_library::switch_cases<1, hypertrie_max_depth + 1>(
+			return template_library::switch_cases<1, htt_t::max_depth + 1>(
 					this->depth_,
 					[&](auto depth_arg) -> size_t {
 						using namespace internal::util;
@@ -317,7 +342,7 @@ namespace dice::hypertrie {
 			using namespace internal::util;
 			using namespace internal::raw;
 
-			return template_library::switch_cases<1, hypertrie_max_depth + 1>(
+			return template_library::switch_cases<1, htt_t::max_depth + 1>(
 					this->depth_,
 					[&](auto depth_arg) -> size_t {
 						RawKey<depth_arg, htt_t> raw_key;
@@ -337,6 +362,66 @@ namespace dice::hypertrie {
 			return get_depth_n_value(raw_key);
 		}
 
+		/**
+		 * Retrieves the values of multiple keys at once. This is faster than looking up each key with operator[] because the
+		 * lookups of keys that share key parts share node lookups and the memory accesses of independent lookups overlap.
+		 * @param keys keys of size depth()
+		 * @param values values[i] is set to the value of keys[i]. Must have the same size as keys.
+		 */
+		void get_many(std::span<Key<htt_t> const> keys, std::span<value_type> values) const {
+			assert(keys.size() == values.size());
+			for_each_value(keys, [&](size_t i, value_type const &value) { values[i] = value; });
+		}
+
+		/**
+		 * Checks for multiple keys at once whether they are contained, i.e. whether their value is not zero. See get_many.
+		 * @param keys keys of size depth()
+		 * @param contained contained[i] is set to whether keys[i] is contained. Must have the same size as keys.
+		 */
+		void contains_many(std::span<Key<htt_t> const> keys, std::span<bool> contained) const {
+			assert(keys.size() == contained.size());
+			for_each_value(keys, [&](size_t i, value_type const &value) { contained[i] = value != value_type{}; });
+		}
+
+	private:
+		/**
+		 * Calls on_value(i, value) with the value of keys[i] for each key.
+		 */
+		template<typename OnValue>
+		void for_each_value(std::span<Key<htt_t> const> keys, OnValue &&on_value) const {
+			if (keys.empty())
+				return;
+			if (this->depth() == 0) {
+				auto const value = decode_depth_0_value(this->node_container_.raw_void_node_ptr());
+				for (size_t i = 0; i < keys.size(); ++i)
+					on_value(i, value);
+				return;
+			}
+			using namespace internal::raw;
+
+			template_library::switch_cases<1, htt_t::max_depth + 1>(
+					this->depth_,
+					[&](auto depth_arg) {
+						std::vector<RawKey_t<depth_arg>> raw_keys(keys.size());
+						for (size_t i = 0; i < keys.size(); ++i) {
+							assert(keys[i].size() == depth_arg);
+							std::copy_n(keys[i].begin(), depth_arg, raw_keys[i].begin());
+						}
+
+						if (contextless()) {
+							auto nodec = this->template stl_node_container<depth_arg>();
+							for (size_t i = 0; i < raw_keys.size(); ++i)
+								on_value(i, RawHypertrieContext_t::template get<depth_arg, std::allocator<std::byte>>(nodec, raw_keys[i]));
+							return;
+						}
+						this->context()->raw_context().template get_many<depth_arg>(this->template node_container<depth_arg>(),
+																					std::span<RawKey_t<depth_arg> const>{raw_keys}, on_value);
+					},
+					[]() { assert(false);  __builtin_unreachable(); });
+		}
+
+	public:
+
 		[[nodiscard]] std::variant<const_Hypertrie, value_type> operator[](SliceKey<htt_t> const &slice_key) const noexcept {
 			assert(slice_key.size() == depth());
 			const size_t fixed_depth = slice_key.get_fixed_depth();
@@ -358,59 +443,95 @@ namespace dice::hypertrie {
 			if (empty()) {
 				return const_Hypertrie(depth() - fixed_depth);
 			}
-			return upperTriangleMatrix<hypertrie_max_depth>(this->depth_, fixed_depth, [&](auto depth_arg, auto slice_key_depth_arg) -> const_Hypertrie<htt_t, allocator_type> {
+			return upperTriangleMatrix<htt_t::max_depth>(this->depth_, fixed_depth, [&](auto depth_arg, auto slice_key_depth_arg) -> const_Hypertrie<htt_t, allocator_type> {
 				if constexpr (depth_arg != slice_key_depth_arg) {
-					RawSliceKey<slice_key_depth_arg, htt_t> raw_slice_key(slice_key);
-					if (contextless()) {
-						auto nodec = stl_node_container<depth_arg>();
-						auto slice_result = RawHypertrieContext_t::slice(nodec, RawSliceKey<slice_key_depth_arg, htt_t>(raw_slice_key));
-						if (slice_result.empty()) {
-							return const_Hypertrie<htt_t, allocator_type>(depth_arg - slice_key_depth_arg);
-						}
-						return {depth_arg - slice_key_depth_arg, nullptr, false, static_cast<RawNodeContainer_t>(slice_result.get_stl_alloc_sen())};
-					}
-
-					auto nodec = this->template node_container<depth_arg>();
-					auto slice_result = this->context()->raw_context().template slice<depth_arg>(nodec, raw_slice_key);
-					if (slice_result.empty()) {
-						return const_Hypertrie<htt_t, allocator_type>(depth_arg - slice_key_depth_arg);
-					}
-					if (slice_result.uses_provided_alloc()) {
-						return {depth_arg - slice_key_depth_arg, this->context(), true, slice_result.get_raw_nodec()};
-					}
-					return {depth_arg - slice_key_depth_arg, nullptr, false, slice_result.get_stl_alloc_sen()};
+					return this->template slice<depth_arg>(RawSliceKey<slice_key_depth_arg, htt_t>(slice_key));
 				}
 				assert(false);
 				__builtin_unreachable();
 			});
 		}
 
-		[[nodiscard]] std::vector<size_t> get_cards(const std::vector<internal::pos_type> &positions) const {
+	protected:
+		/**
+		 * Slices this hypertrie. It must have the given depth and must not be empty.
+		 * @tparam depth depth of this hypertrie
+		 * @tparam fixed_depth number of fixed positions of raw_slice_key; smaller than depth
+		 * @param raw_slice_key the slice key
+		 * @return the slice, a const_Hypertrie of depth depth - fixed_depth
+		 */
+		template<size_t depth, size_t fixed_depth>
+		[[nodiscard]] const_Hypertrie slice(RawSliceKey_t<fixed_depth> const &raw_slice_key) const noexcept {
+			static_assert(fixed_depth < depth);
+			using namespace internal::raw;
+			assert(depth == this->depth() and not this->empty());
+			// a single entry result is written here and then copied into the inline_sen_ of the returned const_Hypertrie
+			stl_SingleEntryNode_t<depth - fixed_depth> sen_result;
+			if (contextless()) {
+				auto nodec = stl_node_container<depth>();
+				auto slice_result = RawHypertrieContext_t::slice(nodec, raw_slice_key, &sen_result);
+				if (slice_result.empty()) {
+					return const_Hypertrie(depth - fixed_depth);
+				}
+				return {depth - fixed_depth, nullptr, false, static_cast<RawNodeContainer_t>(slice_result.get_stl_alloc_sen())};
+			}
+
+			auto nodec = this->template node_container<depth>();
+			auto slice_result = this->context()->template slice<depth>(nodec, raw_slice_key, &sen_result);
+			if (slice_result.empty()) {
+				return const_Hypertrie(depth - fixed_depth);
+			}
+			if (slice_result.uses_provided_alloc()) {
+				return {depth - fixed_depth, this->context(), true, slice_result.get_raw_nodec()};
+			}
+			return {depth - fixed_depth, nullptr, false, slice_result.get_stl_alloc_sen()};
+		}
+
+	public:
+		/**
+		 * Writes the cardinalities of the given positions, i.e. the number of distinct key parts at each of them, to cards without allocating.
+		 * @param positions positions to get the cardinalities for
+		 * @param cards output; must hold at least positions.size() elements
+		 * @return the prefix of cards that was written
+		 */
+		std::span<size_t> get_cards(std::span<internal::pos_type const> positions, std::span<size_t> cards) const noexcept {
 			assert(positions.size() <= depth());
+			assert(cards.size() >= positions.size());
+			auto const written = cards.first(positions.size());
 			if (positions.empty()) {// no positions provided
-				return {};
+				return written;
 			}
 			if (empty()) {
-				return std::vector<size_t>(positions.size(), 0);
+				std::ranges::fill(written, 0);
+				return written;
 			}
 			if (depth() == 1) {
-				return {size()};
+				written[0] = size();
+				return written;
 			}
 			if (size() == 1) {
-				return std::vector<size_t>(positions.size(), 1);
+				std::ranges::fill(written, 1);
+				return written;
 			}
 
 			using namespace internal::util;
 			using namespace internal::raw;
 
-			return template_library::switch_cases<2, hypertrie_max_depth + 1>(
+			template_library::switch_cases<2, htt_t::max_depth + 1>(
 					depth_,
-					[&](auto depth_arg) -> std::vector<size_t> {
+					[&](auto depth_arg) {
 						assert(this->node_container_.is_fn());
 						FNContainer<depth_arg, htt_t, allocator_type> fn_node_container = this->node_container_;
-						return fn_node_container.node_ptr()->getCards(positions);
+						fn_node_container.node_ptr()->getCards(positions, written);
 					},
-					[]() -> std::vector<size_t> { assert(false); __builtin_unreachable(); });
+					[]() { assert(false); __builtin_unreachable(); });
+			return written;
+		}
+
+		[[nodiscard]] std::vector<size_t> get_cards(const std::vector<internal::pos_type> &positions) const {
+			std::vector<size_t> cards(positions.size());
+			get_cards(std::span<internal::pos_type const>{positions}, std::span<size_t>{cards});
+			return cards;
 		}
 
 		using iterator = Iterator<htt_t, allocator_type>;
@@ -495,7 +616,7 @@ namespace dice::hypertrie {
 				return old_value;
 			}
 			// TODO: it seems like The raw_context() is problematic.
-			auto result = template_library::switch_cases<1, hypertrie_max_depth + 1>(
+			auto result = template_library::switch_cases<1, htt_t::max_depth + 1>(
 					this->depth_,
 					[&](auto depth_arg) -> value_type {
 						RawKey<depth_arg, htt_t> raw_key{};
@@ -512,11 +633,52 @@ namespace dice::hypertrie {
 			return result;
 		}
 
+		/**
+		 * Loads entries into this hypertrie, which must be empty. The nodes are built directly from the entries,
+		 * which is much faster than inserting them (e.g. with a BulkInserter). Entries that are sorted already are not sorted again.
+		 * @tparam depth depth of this hypertrie
+		 * @param entries entries of the hypertrie; key parts and values must not be zero equivalent. Duplicates are removed.
+		 * @throws std::logic_error if this hypertrie is not empty or has another depth
+		 */
+		template<size_t depth>
+		void load(std::vector<internal::raw::SingleEntry<depth, htt_t>> &&entries) {
+			if (depth != this->depth() or not this->empty()) [[unlikely]]
+				throw std::logic_error{"Only empty hypertries of the same depth can be loaded."};
+			internal::raw::NodeContainer<depth, htt_t, allocator_type> nodec{this->node_container_};
+			this->context()->raw_context().template load<depth>(nodec, std::move(entries));
+			this->node_container_ = nodec;
+		}
+
+		/**
+		 * Loads entries into this hypertrie, which must be empty. See load(std::vector<SingleEntry<depth, htt_t>> &&).
+		 * @param entries entries of the hypertrie. Their size must be the depth of this hypertrie.
+		 * @throws std::logic_error if this hypertrie is not empty or an entry has a wrong size
+		 */
+		void load(std::vector<NonZeroEntry<htt_t>> const &entries) {
+			using namespace internal::raw;
+			if (this->depth() == 0) [[unlikely]]
+				throw std::logic_error{"Hypertries of depth 0 cannot be loaded."};
+			template_library::switch_cases<1, htt_t::max_depth + 1>(
+					this->depth_,
+					[&](auto depth_arg) {
+						std::vector<SingleEntry<depth_arg, htt_t>> raw_entries;
+						raw_entries.reserve(entries.size());
+						for (auto const &entry : entries) {
+							if (entry.size() != depth_arg) [[unlikely]]
+								throw std::logic_error{"The provided NonZeroEntry has a wrong depth/size."};
+							RawKey<depth_arg, htt_t> raw_key;
+							std::copy(entry.key().begin(), entry.key().end(), raw_key.begin());
+							raw_entries.emplace_back(raw_key, entry.value());
+						}
+						this->template load<depth_arg>(std::move(raw_entries));
+					});
+		}
+
 		Hypertrie(const Hypertrie<htt_t, allocator_type> &hypertrie) noexcept : const_Hypertrie<htt_t, allocator_type>(hypertrie) {
 			using namespace internal::util;
 			using namespace internal::raw;
 			if (not this->empty() and this->depth() != 0)
-				template_library::switch_cases<1, hypertrie_max_depth + 1>(
+				template_library::switch_cases<1, htt_t::max_depth + 1>(
 						this->depth_,
 						[&](auto depth_arg) {
 							if constexpr (bool_valued_and_taggable_key_part and depth_arg  < sen_min_depth) {
@@ -536,7 +698,7 @@ namespace dice::hypertrie {
 				if (this->contextless()) {// TODO: add copying contextless hypertries
 					throw std::logic_error{"Copying contextless const_Hypertries is not yet supported."};
 				}
-				template_library::switch_cases<1UL, hypertrie_max_depth + 1>(
+				template_library::switch_cases<1UL, htt_t::max_depth + 1>(
 						this->depth_,
 						[&](auto depth_arg) {
 							if constexpr (bool_valued_and_taggable_key_part and depth_arg  < sen_min_depth) {
@@ -557,7 +719,7 @@ namespace dice::hypertrie {
 				if (hypertrie.contextless()) {// TODO: add copying contextless hypertries
 					throw std::logic_error{"Copying contextless const_Hypertries is not yet supported."};
 				}
-				template_library::switch_cases<1UL, hypertrie_max_depth + 1>(
+				template_library::switch_cases<1UL, htt_t::max_depth + 1>(
 						this->depth_,
 						[&](auto depth_arg) {
 							if constexpr (bool_valued_and_taggable_key_part and depth_arg  < sen_min_depth) {
@@ -596,7 +758,7 @@ namespace dice::hypertrie {
 			using namespace internal::raw;
 			if (not this->empty() and this->depth() != 0) {
 				assert(not this->contextless());
-				template_library::switch_cases<1, hypertrie_max_depth + 1>(
+				template_library::switch_cases<1, htt_t::max_depth + 1>(
 						this->depth_,
 						[&](auto depth_arg) {
 							NodeContainer<depth_arg, htt_t, allocator_type> nodec{this->node_container_};
@@ -7,7 +7,9 @@
 #include "dice/hypertrie/Hypertrie_trait.hpp"
 #include "dice/hypertrie/hypertrie_allocator_trait.hpp"
 #include "dice/hypertrie/internal/raw/node_context/RawHypertrieContext.hpp"
+#include "dice/hypertrie/internal/raw/node_context/SliceCache.hpp"
 
+#include <cassert>
 #include <memory>
 
 
@@ -16,18 +18,22 @@ namespace dice::hypertrie {
 	template<HypertrieTrait htt_t, ByteAllocator allocator_type>
 	class HypertrieContext {
 	private:
-		static constexpr size_t max_depth_ = hypertrie_max_depth;
+		static constexpr size_t max_depth_ = htt_t::max_depth;
 
 		using ht_alloc_trait_t = hypertrie_allocator_trait<allocator_type>;
 
 	public:
 		using RawHypertrieContext_t = typename internal::raw::template RawHypertrieContext<max_depth_, htt_t, allocator_type>;
+		using SliceCache_t = internal::raw::SliceCache<max_depth_, htt_t, allocator_type>;
+		using SliceCacheStats = internal::raw::SliceCacheStats;
 
 	private:
 		typename ht_alloc_trait_t::template pointer<RawHypertrieContext_t> raw_context_;
 
 		allocator_type alloc_;
 
+		SliceCache_t slice_cache_;
+
 		using ht_ctx_alloc_type = typename ht_alloc_trait_t::template rebind_alloc<RawHypertrieContext_t>;
 
 	public:
@@ -37,14 +43,19 @@ namespace dice::hypertrie {
 		HypertrieContext &operator=(HypertrieContext const &) = delete;
 		HypertrieContext &operator=(HypertrieContext &&) = delete;
 
-		explicit HypertrieContext(allocator_type const &alloc)
+		/**
+		 * @param alloc allocator for the nodes
+		 * @param slice_cache_capacity maximal number of slices that are memoized (see slice()). With 0, slices are not memoized.
+		 */
+		explicit HypertrieContext(allocator_type const &alloc, size_t slice_cache_capacity = 0)
 			: raw_context_([&]() {
 				  ht_ctx_alloc_type alloc_ht_ctx = alloc;
 				  auto ht_ctx_ptr = std::allocator_traits<ht_ctx_alloc_type>::allocate(alloc_ht_ctx, 1);
 				  std::allocator_traits<ht_ctx_alloc_type>::construct(alloc_ht_ctx, std::to_address(ht_ctx_ptr), alloc);
 				  return ht_ctx_ptr;
 			  }()),
-			  alloc_(alloc) {}
+			  alloc_(alloc),
+			  slice_cache_(slice_cache_capacity, alloc) {}
 
 		~HypertrieContext() {
 			ht_ctx_alloc_type alloc_ht_ctx = alloc_;
@@ -58,6 +69,68 @@ namespace dice::hypertrie {
 		RawHypertrieContext_t &raw_context() noexcept {
 			return *raw_context_;
 		}
+
+		/**
+		 * Slices a node like RawHypertrieContext::slice. If the slice cache is enabled, slices of full nodes that result in a node of this context
+		 * (or in nothing) are memoized by the identifier of nodec and the slice key.
+		 * @tparam depth depth of the node container
+		 * @tparam fixed_keyparts number of fixed key_parts in the slice key
+		 * @param nodec a container with a node of this context
+		 * @param raw_slice_key the slice key
+		 * @param sen_result_cache see RawHypertrieContext::slice
+		 * @return see RawHypertrieContext::slice
+		 */
+		template<size_t depth, size_t fixed_keyparts>
+		auto slice(internal::raw::NodeContainer<depth, htt_t, allocator_type> const &nodec, internal::raw::RawSliceKey<fixed_keyparts, htt_t> const &raw_slice_key,
+				   internal::raw::SingleEntryNode<depth - fixed_keyparts, htt_t, std::allocator<std::byte>> *sen_result_cache = nullptr) noexcept {
+			using namespace internal::raw;
+			if constexpr (fixed_keyparts > 0 and fixed_keyparts < depth) {
+				if (slice_cache_.enabled() and nodec.is_fn()) {
+					static constexpr size_t result_depth = depth - fixed_keyparts;
+					using SliceResult_t = SliceResult<result_depth, htt_t, allocator_type>;
+
+					typename SliceCache_t::Key const key{nodec.identifier(), depth, raw_slice_key};
+					if (auto cached = slice_cache_.find(key); cached.has_value()) {
+						auto const result_id = static_cast<RawIdentifier<result_depth, htt_t>>(Identifier<htt_t>{*cached});
+						if (result_id.empty())
+							return SliceResult_t{};
+						// the result is a descendant of nodec, so it exists as long as nodec does
+						if constexpr (result_depth == 1 and HypertrieTrait_bool_valued_and_taggable_key_part<htt_t>) {
+							if (result_id.is_sen())
+								return SliceResult_t::make_with_provided_alloc(SENContainer<result_depth, htt_t, allocator_type>{result_id});
+							return SliceResult_t::make_with_provided_alloc(FNContainer<result_depth, htt_t, allocator_type>{result_id, raw_context().node_storage_.template lookup<result_depth, FullNode>(result_id)});
+						} else {
+							auto result_nodec = raw_context().node_storage_.template lookup<result_depth>(result_id);
+							assert(not result_nodec.empty());
+							return SliceResult_t::make_with_provided_alloc(result_nodec);
+						}
+					}
+
+					auto result = raw_context().template slice<depth>(nodec, raw_slice_key, sen_result_cache);
+					if (result.empty())
+						slice_cache_.insert(key, Identifier<htt_t>::seed_);
+					else if (result.uses_provided_alloc())
+						slice_cache_.insert(key, result.get_raw_nodec().identifier().hash());
+					return result;
+				}
+			}
+			return raw_context().template slice<depth>(nodec, raw_slice_key, sen_result_cache);
+		}
+
+		[[nodiscard]] SliceCacheStats slice_cache_stats() const noexcept {
+			return slice_cache_.stats();
+		}
+
+		void reset_slice_cache_stats() noexcept {
+			slice_cache_.reset_stats();
+		}
+
+		/**
+		 * Removes all memoized slices. This is never needed for correctness, but frees the memory of slices that are not used anymore.
+		 */
+		void clear_slice_cache() noexcept {
+			slice_cache_.clear();
+		}
 	};
 
 	template<HypertrieTrait htt_t, ByteAllocator allocator_type>
@@ -3,9 +3,17 @@
 
 #include <cctype>
 
+// set by the CMake option HYPERTRIE_MAX_DEPTH
+#ifndef DICE_HYPERTRIE_MAX_DEPTH
+#define DICE_HYPERTRIE_MAX_DEPTH 5
+#endif
+
 namespace dice::hypertrie {
-	// TODO: add option to override this at startup
-	static constexpr std::size_t hypertrie_max_depth = 5;
+	/**
+	 * Default for the maximum depth of a Hypertrie_t (see Hypertrie_t::max_depth).
+	 * Every supported depth is instantiated by the runtime depth dispatch, so larger values cost compile time and binary size.
+	 */
+	static constexpr std::size_t hypertrie_max_depth = DICE_HYPERTRIE_MAX_DEPTH;
 	static_assert(hypertrie_max_depth >= 1);
 }// namespace dice::hypertrie
 #endif//HYPERTRIE_CONFIGHYPERTRIEDEPTHLIMIT_HPP
@@ -0,0 +1,107 @@
+#ifndef HYPERTRIE_HYPERTRIESNAPSHOT_HPP
+#define HYPERTRIE_HYPERTRIESNAPSHOT_HPP
+
+#include "dice/hypertrie/Hypertrie.hpp"
+#include "dice/hypertrie/HypertrieContext.hpp"
+#include "dice/hypertrie/internal/raw/node_context/SnapshotRegistry.hpp"
+#include "dice/hypertrie/internal/util/EpochManager.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace dice::hypertrie {
+
+	/**
+	 * A consistent, read-only view of a published hypertrie (see SnapshotManager).
+	 * The nodes of the snapshot stay valid until the snapshot is destructed, even if the hypertrie is updated in the meantime.
+	 * Must not be used to create a Hypertrie, because that modifies reference counts.
+	 */
+	template<HypertrieTrait htt_t, ByteAllocator allocator_type>
+	class HypertrieSnapshot {
+		// declared first so that it is released last
+		internal::util::EpochManager::Pin pin_;
+		const_Hypertrie<htt_t, allocator_type> hypertrie_;
+
+	public:
+		HypertrieSnapshot(internal::util::EpochManager::Pin &&pin, const_Hypertrie<htt_t, allocator_type> &&hypertrie) noexcept
+			: pin_(std::move(pin)), hypertrie_(std::move(hypertrie)) {}
+
+		HypertrieSnapshot(HypertrieSnapshot const &) = delete;
+		HypertrieSnapshot &operator=(HypertrieSnapshot const &) = delete;
+		HypertrieSnapshot(HypertrieSnapshot &&) noexcept = default;
+		HypertrieSnapshot &operator=(HypertrieSnapshot &&) noexcept = default;
+
+		[[nodiscard]] const_Hypertrie<htt_t, allocator_type> const &hypertrie() const noexcept { return hypertrie_; }
+
+		const_Hypertrie<htt_t, allocator_type> const &operator*() const noexcept { return hypertrie_; }
+
+		const_Hypertrie<htt_t, allocator_type> const *operator->() const noexcept { return &hypertrie_; }
+	};
+
+	/**
+	 * Provides snapshot reads of hypertries of a HypertrieContext while they are updated by a BulkUpdater.
+	 *
+	 * A writer publishes a hypertrie and passes the SnapshotManager to its BulkUpdater. Every bulk that is applied then becomes
+	 * visible to readers as a whole. Readers take a HypertrieSnapshot of the last committed state without blocking the writer.
+	 * Nodes that are reachable from a snapshot are neither changed nor deleted until all snapshots of that state are gone.
+	 *
+	 * The SnapshotManager is runtime-only state and is not stored in the HypertrieContext (which might be persisted by its allocator).
+	 * Hypertries must be unpublished before they are destructed.
+	 * @tparam htt_t HypertrieTrait; its node storage must be sharded so that lookups are thread-safe
+	 * @tparam allocator_type allocator of the HypertrieContext
+	 */
+	template<HypertrieTrait htt_t, ByteAllocator allocator_type>
+	class SnapshotManager {
+		static_assert(htt_t::node_storage_shards > 1, "Snapshot reads require a sharded node storage (see Hypertrie_t::node_storage_shards).");
+
+	public:
+		using SnapshotRegistry_t = internal::raw::SnapshotRegistry<htt_t::max_depth, htt_t, allocator_type>;
+
+	private:
+		SnapshotRegistry_t registry_;
+
+	public:
+		explicit SnapshotManager(HypertrieContext<htt_t, allocator_type> &context) noexcept : registry_(context.raw_context()) {}
+
+		/**
+		 * Publishes the current state of hypertrie. From now on, it must be updated only by BulkUpdaters that use this SnapshotManager.
+		 */
+		void publish(const_Hypertrie<htt_t, allocator_type> const &hypertrie) {
+			registry_.publish(hypertrie.depth(), *hypertrie.raw_node_container());
+		}
+
+		/**
+		 * Stops publishing hypertrie. Snapshots that were taken before stay valid.
+		 */
+		void unpublish(const_Hypertrie<htt_t, allocator_type> const &hypertrie) {
+			registry_.unpublish(*hypertrie.raw_node_container());
+		}
+
+		/**
+		 * Takes a snapshot of the last committed state of hypertrie. Thread-safe.
+		 * @param hypertrie a published hypertrie
+		 * @return the snapshot
+		 * @throws std::logic_error if hypertrie is not published
+		 */
+		[[nodiscard]] HypertrieSnapshot<htt_t, allocator_type> snapshot(const_Hypertrie<htt_t, allocator_type> const &hypertrie) const {
+			auto [pin, root] = registry_.snapshot(*hypertrie.raw_node_container());
+			if (root == nullptr)
+				throw std::logic_error{"The hypertrie is not published."};
+			return {std::move(pin), const_Hypertrie<htt_t, allocator_type>{root->depth, hypertrie.context(), true, root->nodec}};
+		}
+
+		/**
+		 * Releases nodes that are not reachable from any snapshot anymore. This is also done with every commit.
+		 */
+		void collect() {
+			registry_.collect();
+		}
+
+		SnapshotRegistry_t &raw_registry() noexcept {
+			return registry_;
+		}
+	};
+
+}// namespace dice::hypertrie
+
+#endif//HYPERTRIE_HYPERTRIESNAPSHOT_HPP
@@ -9,8 +9,11 @@ namespace dice::hypertrie {
 			 typename value_type_t,
 			 template<typename, typename, typename> class map_type_t = hypertrie::internal::container::dice_sparse_map,
 			 template<typename, typename> class set_type_t = hypertrie::internal::container::dice_sparse_set,
-			 ssize_t key_part_tagging_bit = -1>
-	using Hypertrie_trait = Hypertrie_t<key_part_type_t, value_type_t, map_type_t, set_type_t, key_part_tagging_bit>;
+			 ssize_t key_part_tagging_bit = -1,
+			 size_t node_storage_shards = 1,
+			 bool prefetch_lookups = false,
+			 size_t max_depth = hypertrie_max_depth>
+	using Hypertrie_trait = Hypertrie_t<key_part_type_t, value_type_t, map_type_t, set_type_t, key_part_tagging_bit, node_storage_shards, prefetch_lookups, max_depth>;
 
 	using default_bool_Hypertrie_trait = Hypertrie_trait<unsigned long,
 														 bool,
@@ -22,6 +25,21 @@ namespace dice::hypertrie {
 														hypertrie::internal::container::dice_sparse_set,
 														63>;
 
+	using sharded_tagged_bool_Hypertrie_trait = Hypertrie_trait<unsigned long,
+																bool,
+																hypertrie::internal::container::dice_sparse_map,
+																hypertrie::internal::container::dice_sparse_set,
+																63,
+																16>;
+
+	using prefetching_tagged_bool_Hypertrie_trait = Hypertrie_trait<unsigned long,
+																	bool,
+																	hypertrie::internal::container::dice_sparse_map,
+																	hypertrie::internal::container::dice_sparse_set,
+																	63,
+																	1,
+																	true>;
+
 	using default_long_Hypertrie_trait = Hypertrie_trait<unsigned long,
 														 long,
 														 hypertrie::internal::container::dice_sparse_map,
@@ -13,6 +13,18 @@ namespace dice::hypertrie {
 	template<HypertrieTrait tr, ByteAllocator allocator_type>
 	class Hypertrie;
 
+	template<HypertrieTrait tr, ByteAllocator allocator_type>
+	class SnapshotManager;
+
+	template<size_t depth, HypertrieTrait tr, ByteAllocator allocator_type>
+	class const_StaticHypertrie;
+
+	template<size_t depth, HypertrieTrait tr, ByteAllocator allocator_type>
+	class StaticIterator;
+
+	template<size_t diag_depth, size_t depth, HypertrieTrait tr, ByteAllocator allocator_type>
+	class StaticHashDiagonal;
+
 }// namespace dice::hypertrie
 
 
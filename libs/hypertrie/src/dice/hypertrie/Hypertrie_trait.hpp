@@ -1,6 +1,8 @@
 #ifndef HYPERTRIE_HYPERTRIE_TRAIT_HPP
 #define HYPERTRIE_HYPERTRIE_TRAIT_HPP
 
+#include "dice/hypertrie/HypertrieContextConfig.hpp"
+
 #include <optional>
 #include <string>
 #include <vector>
@@ -11,7 +13,10 @@ namespace dice::hypertrie {
 			 typename value_type_t,
 			 template<typename, typename, typename> class map_type_t,
 			 template<typename, typename> class set_type_t,
-			 ssize_t key_part_tagging_bit_v = -1>
+			 ssize_t key_part_tagging_bit_v = -1,
+			 size_t node_storage_shards_v = 1,
+			 bool prefetch_lookups_v = false,
+			 size_t max_depth_v = hypertrie_max_depth>
 	struct Hypertrie_t {
 		using key_part_type = key_part_type_t;
 		using value_type = value_type_t;
@@ -25,6 +30,22 @@ namespace dice::hypertrie {
 		static constexpr bool is_bool_valued = std::is_same_v<value_type, bool>;
 		static constexpr ssize_t key_part_tagging_bit = key_part_tagging_bit_v;
 		static constexpr bool taggable_key_part = key_part_tagging_bit != -1;
+		/**
+		 * Number of shards the node maps of a HypertrieContext are split into. Must be a power of two.
+		 * With more than one shard, each shard is guarded by its own lock (see internal::container::ShardedMap).
+		 */
+		static constexpr size_t node_storage_shards = node_storage_shards_v;
+		/**
+		 * If true, lookups (get, slice) prefetch each child node as soon as it is resolved, so that the cache misses on
+		 * its cache lines overlap instead of being taken one after another while the node is inspected.
+		 */
+		static constexpr bool prefetch_lookups = prefetch_lookups_v;
+		/**
+		 * Maximum depth of hypertries with this trait. HypertrieContext, Hypertrie, Iterator, HashDiagonal and BulkUpdater
+		 * instantiate their depth dispatch for the depths 1 ... max_depth.
+		 */
+		static constexpr size_t max_depth = max_depth_v;
+		static_assert(max_depth >= 1);
 	};
 
 	namespace internal::hypertrie_trait {
@@ -32,7 +53,10 @@ namespace dice::hypertrie {
 									  typename,
 									  template<typename, typename, typename> class,
 									  template<typename, typename> class,
-									  ssize_t>
+									  ssize_t,
+									  size_t,
+									  bool,
+									  size_t>
 							 typename U>
 		struct is_instance_impl : public std::false_type {
 		};
@@ -41,21 +65,30 @@ namespace dice::hypertrie {
 						  typename,
 						  template<typename, typename, typename> class,
 						  template<typename, typename> class,
-						  ssize_t>
+						  ssize_t,
+						  size_t,
+						  bool,
+						  size_t>
 				 typename U,
 				 typename key_part_type_t,
 				 typename value_type_t,
 				 template<typename, typename, typename> class map_type_t,
 				 template<typename, typename> class set_type_t,
-				 ssize_t value_type_tagging_bit_v>
-		struct is_instance_impl<U<key_part_type_t, value_type_t, map_type_t, set_type_t, value_type_tagging_bit_v>, U> : public std::true_type {
+				 ssize_t value_type_tagging_bit_v,
+				 size_t node_storage_shards_v,
+				 bool prefetch_lookups_v,
+				 size_t max_depth_v>
+		struct is_instance_impl<U<key_part_type_t, value_type_t, map_type_t, set_type_t, value_type_tagging_bit_v, node_storage_shards_v, prefetch_lookups_v, max_depth_v>, U> : public std::true_type {
 		};
 
 		template<typename T, template<typename,
 									  typename,
 									  template<typename, typename, typename> class,
 									  template<typename, typename> class,
-									  ssize_t>
+									  ssize_t,
+									  size_t,
+									  bool,
+									  size_t>
 							 typename U>
 		using is_instance = is_instance_impl<std::decay_t<T>, U>;
 	}// namespace internal::hypertrie_trait
@@ -68,6 +101,9 @@ namespace dice::hypertrie {
 		{ T::is_bool_valued } -> std::convertible_to<bool>;
 		{ T::key_part_tagging_bit } -> std::convertible_to<ssize_t>;
 		{ T::taggable_key_part } -> std::convertible_to<bool>;
+		{ T::node_storage_shards } -> std::convertible_to<size_t>;
+		{ T::prefetch_lookups } -> std::convertible_to<bool>;
+		{ T::max_depth } -> std::convertible_to<size_t>;
 	};
 
 	template<class T>
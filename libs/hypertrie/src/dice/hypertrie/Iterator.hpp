@@ -13,9 +13,9 @@ namespace dice::hypertrie {
 		using key_part_type = typename htt_t::key_part_type;
 
 	protected:
-		using max_sized_RawIterator_t = internal::raw::RawIterator<hypertrie_max_depth, false, htt_t, allocator_type, hypertrie_max_depth>;
+		using max_sized_RawIterator_t = internal::raw::RawIterator<htt_t::max_depth, false, htt_t, allocator_type, htt_t::max_depth>;
 		template<size_t depth>
-		using RawIterator_t = internal::raw::RawIterator<depth, false, htt_t, allocator_type, hypertrie_max_depth>;
+		using RawIterator_t = internal::raw::RawIterator<depth, false, htt_t, allocator_type, htt_t::max_depth>;
 
 		// TODO: same as in HashDiagonal.hpp. Rewrite with typical inheritance might advance readability.
 		//  However the runtime cost might be problematic.
@@ -67,8 +67,8 @@ namespace dice::hypertrie {
 		inline static const std::vector<RawMethods> raw_method_cache = []() noexcept {
 			using namespace internal;
 			std::vector<RawMethods> raw_methods;
-			for (size_t depth = 1; depth < hypertrie_max_depth + 1; ++depth) {
-				raw_methods.push_back(template_library::switch_cases<1, hypertrie_max_depth + 1>(
+			for (size_t depth = 1; depth < htt_t::max_depth + 1; ++depth) {
+				raw_methods.push_back(template_library::switch_cases<1, htt_t::max_depth + 1>(
 						depth,
 						[](auto depth_arg) -> RawMethods {
 							return generate_raw_methods<depth_arg>();
@@ -0,0 +1,307 @@
+#ifndef HYPERTRIE_STATICHYPERTRIE_HPP
+#define HYPERTRIE_STATICHYPERTRIE_HPP
+
+#include "dice/hypertrie/Hypertrie.hpp"
+#include "dice/hypertrie/Hypertrie_predeclare.hpp"
+#include "dice/hypertrie/internal/raw/RawDiagonalPositions.hpp"
+#include "dice/hypertrie/internal/raw/RawKey.hpp"
+#include "dice/hypertrie/internal/raw/iteration/RawHashDiagonal.hpp"
+#include "dice/hypertrie/internal/raw/iteration/RawIterator.hpp"
+
+#include <cassert>
+#include <variant>
+
+namespace dice::hypertrie {
+
+	/**
+	 * A read-only view on a const_Hypertrie whose depth is known at compile time.
+	 * <p>const_Hypertrie dispatches every operation on its runtime depth (switch_cases or tables of function pointers).
+	 * const_StaticHypertrie, StaticIterator and StaticHashDiagonal call the raw implementations for the given depth directly,
+	 * so they can be inlined into tight loops. Keys are RawKeys (std::arrays) instead of heap allocated Keys.</p>
+	 * <p>Use dynamic() to switch back to the runtime-depth API. Writes are done on the Hypertrie the view was created from.</p>
+	 * @tparam depth depth of the hypertrie
+	 * @tparam htt_t hypertrie trait
+	 * @tparam allocator_type allocator of the HypertrieContext
+	 */
+	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type>
+	class const_StaticHypertrie {
+		static_assert(depth >= 1 and depth <= htt_t::max_depth);
+
+		template<size_t, HypertrieTrait, ByteAllocator>
+		friend class const_StaticHypertrie;
+		template<size_t, size_t, HypertrieTrait, ByteAllocator>
+		friend class StaticHashDiagonal;
+
+	public:
+		using key_part_type = typename htt_t::key_part_type;
+		using value_type = typename htt_t::value_type;
+		using RawKey_t = internal::raw::RawKey<depth, htt_t>;
+		template<size_t fixed_depth>
+		using RawSliceKey_t = internal::raw::RawSliceKey<fixed_depth, htt_t>;
+		using RawKeyPositions_t = internal::raw::RawKeyPositions<depth>;
+
+		using iterator = StaticIterator<depth, htt_t, allocator_type>;
+		using const_iterator = iterator;
+
+	private:
+		const_Hypertrie<htt_t, allocator_type> hypertrie_;
+
+	public:
+		const_StaticHypertrie() : hypertrie_(depth) {}
+
+		/**
+		 * @param hypertrie the hypertrie to view. Its depth must be depth.
+		 */
+		explicit const_StaticHypertrie(const_Hypertrie<htt_t, allocator_type> hypertrie) noexcept
+			: hypertrie_(std::move(hypertrie)) {
+			assert(hypertrie_.depth() == depth);
+		}
+
+		/**
+		 * @return the viewed hypertrie with the runtime-depth API
+		 */
+		[[nodiscard]] const_Hypertrie<htt_t, allocator_type> const &dynamic() const noexcept {
+			return hypertrie_;
+		}
+
+		[[nodiscard]] static constexpr size_t get_depth() noexcept {
+			return depth;
+		}
+
+		[[nodiscard]] bool empty() const noexcept {
+			return hypertrie_.empty();
+		}
+
+		[[nodiscard]] size_t size() const noexcept {
+			using namespace internal::raw;
+			if (hypertrie_.empty())
+				return 0;
+			if (hypertrie_.node_container_.is_sen())
+				return 1;
+			return hypertrie_.template node_container<depth>().template specific<FullNode>().node_ptr()->size();
+		}
+
+		[[nodiscard]] value_type operator[](RawKey_t const &raw_key) const noexcept {
+			if (hypertrie_.empty())
+				return value_type{};
+			return hypertrie_.template get_depth_n_value<depth>(raw_key);
+		}
+
+		[[nodiscard]] value_type operator[](Key<htt_t> const &key) const noexcept {
+			assert(key.size() == depth);
+			RawKey_t raw_key;
+			std::copy_n(key.begin(), depth, raw_key.begin());
+			return (*this)[raw_key];
+		}
+
+		/**
+		 * Slices the hypertrie.
+		 * @tparam fixed_depth number of fixed positions; smaller than depth
+		 * @param raw_slice_key the fixed positions and key parts
+		 * @return the slice
+		 */
+		template<size_t fixed_depth>
+		[[nodiscard]] const_StaticHypertrie<depth - fixed_depth, htt_t, allocator_type> slice(RawSliceKey_t<fixed_depth> const &raw_slice_key) const noexcept {
+			static_assert(fixed_depth >= 1 and fixed_depth < depth);
+			if (hypertrie_.empty())
+				return {};
+			return const_StaticHypertrie<depth - fixed_depth, htt_t, allocator_type>{hypertrie_.template slice<depth>(raw_slice_key)};
+		}
+
+		/**
+		 * @tparam diag_depth number of positions in diag_poss
+		 * @param diag_poss the positions of the diagonal
+		 * @return the diagonal; the hypertrie must not be empty
+		 */
+		template<size_t diag_depth>
+		[[nodiscard]] StaticHashDiagonal<diag_depth, depth, htt_t, allocator_type> diagonal(RawKeyPositions_t const &diag_poss) const noexcept {
+			return StaticHashDiagonal<diag_depth, depth, htt_t, allocator_type>{*this, diag_poss};
+		}
+
+		[[nodiscard]] iterator begin() const noexcept {
+			return iterator{*this};
+		}
+
+		[[nodiscard]] const_iterator cbegin() const noexcept { return this->begin(); }
+
+		[[nodiscard]] bool end() const noexcept { return false; }
+
+		[[nodiscard]] bool cend() const noexcept { return false; }
+	};
+
+	/**
+	 * Iterator over the entries of a const_StaticHypertrie. Entries are SingleEntries, i.e. the key is a RawKey.
+	 */
+	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type>
+	class StaticIterator {
+		using RawIterator_t = internal::raw::RawIterator<depth, true, htt_t, allocator_type, htt_t::max_depth>;
+
+		RawIterator_t raw_iterator_;
+
+		static RawIterator_t construct(const_Hypertrie<htt_t, allocator_type> const &hypertrie) noexcept {
+			if (hypertrie.empty())
+				return {};
+			if (hypertrie.contextless())
+				return RawIterator_t{hypertrie.template stl_node_container<depth>()};
+			return {hypertrie.template node_container<depth>(), hypertrie.context()->raw_context()};
+		}
+
+	public:
+		using value_type = typename RawIterator_t::value_type;
+
+		StaticIterator() = default;
+
+		explicit StaticIterator(const_StaticHypertrie<depth, htt_t, allocator_type> const &hypertrie) noexcept
+			: raw_iterator_(construct(hypertrie.dynamic())) {}
+
+		StaticIterator &operator++() noexcept {
+			raw_iterator_.inc();
+			return *this;
+		}
+
+		StaticIterator operator++(int) noexcept {
+			auto copy = *this;
+			++(*this);
+			return copy;
+		}
+
+		value_type const &operator*() const noexcept { return raw_iterator_.value(); }
+
+		value_type const *operator->() const noexcept { return &raw_iterator_.value(); }
+
+		operator bool() const noexcept { return not raw_iterator_.ended(); }
+	};
+
+	/**
+	 * The HashDiagonal of a const_StaticHypertrie. See HashDiagonal for the semantics.
+	 * @tparam diag_depth number of diagonal positions
+	 * @tparam depth depth of the hypertrie
+	 */
+	template<size_t diag_depth, size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type>
+	class StaticHashDiagonal {
+		static_assert(diag_depth >= 1 and diag_depth <= depth);
+
+	public:
+		using key_part_type = typename htt_t::key_part_type;
+		using value_type = typename htt_t::value_type;
+		static constexpr size_t result_depth = depth - diag_depth;
+
+	private:
+		template<template<size_t, typename, typename> typename node_type, ByteAllocator node_allocator_type>
+		using RawHashDiagonal_t = internal::raw::RawHashDiagonal<diag_depth, depth, node_type, htt_t, node_allocator_type, htt_t::max_depth>;
+
+		// the same three cases as in HashDiagonal: full node, single entry node in the context and contextless single entry node
+		std::variant<RawHashDiagonal_t<internal::raw::FullNode, allocator_type>,
+					 RawHashDiagonal_t<internal::raw::SingleEntryNode, allocator_type>,
+					 RawHashDiagonal_t<internal::raw::SingleEntryNode, std::allocator<std::byte>>>
+				raw_hash_diagonal_;
+		HypertrieContext_ptr<htt_t, allocator_type> context_;
+
+		static auto construct(const_Hypertrie<htt_t, allocator_type> const &hypertrie, internal::raw::RawKeyPositions<depth> const &diag_poss) noexcept {
+			using namespace internal::raw;
+			assert(not hypertrie.empty());
+			using variant_t = decltype(raw_hash_diagonal_);
+			if (hypertrie.contextless())
+				return variant_t{std::in_place_index<2>, SENContainer<depth, htt_t, std::allocator<std::byte>>{*hypertrie.raw_node_container()}, diag_poss};
+			if (hypertrie.size() == 1)
+				return variant_t{std::in_place_index<1>, SENContainer<depth, htt_t, allocator_type>{*hypertrie.raw_node_container()}, diag_poss};
+			return variant_t{std::in_place_index<0>, FNContainer<depth, htt_t, allocator_type>{hypertrie.template node_container<depth>()}, diag_poss, hypertrie.context()->raw_context()};
+		}
+
+	public:
+		/**
+		 * @param hypertrie the hypertrie from that the diagonal is extracted. Must not be empty.
+		 * @param diag_poss the positions of the diagonal
+		 */
+		StaticHashDiagonal(const_StaticHypertrie<depth, htt_t, allocator_type> const &hypertrie, internal::raw::RawKeyPositions<depth> const &diag_poss) noexcept
+			: raw_hash_diagonal_(construct(hypertrie.dynamic(), diag_poss)),
+			  context_(hypertrie.dynamic().context()) {
+			assert(diag_poss.count() == diag_depth);
+		}
+
+		/**
+		 * Begin the iteration over non-zero diagonal slices.
+		 * @return reference to self
+		 */
+		StaticHashDiagonal &begin() noexcept {
+			std::visit([](auto &raw_hash_diagonal) { raw_hash_diagonal.begin(); }, raw_hash_diagonal_);
+			return *this;
+		}
+
+		[[nodiscard]] bool end() const noexcept {
+			return false;
+		}
+
+		/**
+		 * Only valid while iterating, i.e. after begin() and before ended().
+		 */
+		[[nodiscard]] key_part_type current_key_part() const noexcept {
+			assert(not ended());
+			return std::visit([](auto const &raw_hash_diagonal) -> key_part_type { return raw_hash_diagonal.current_key_part(); }, raw_hash_diagonal_);
+		}
+
+		/**
+		 * Only valid while iterating or after find() returned true. Requires diag_depth < depth.
+		 * @return the slice of the hypertrie at the diagonal positions with the current key part
+		 */
+		[[nodiscard]] const_StaticHypertrie<result_depth, htt_t, allocator_type> current_hypertrie() const noexcept
+			requires(result_depth > 0)
+		{
+			return std::visit([&](auto const &raw_hash_diagonal) -> const_StaticHypertrie<result_depth, htt_t, allocator_type> {
+				auto const &value = raw_hash_diagonal.current_value();
+				if (value.uses_provided_alloc())
+					return const_StaticHypertrie<result_depth, htt_t, allocator_type>{const_Hypertrie<htt_t, allocator_type>{result_depth, context_, true, value.get_raw_nodec()}};
+				return const_StaticHypertrie<result_depth, htt_t, allocator_type>{const_Hypertrie<htt_t, allocator_type>{result_depth, nullptr, true, value.get_stl_alloc_sen()}};
+			},
+							  raw_hash_diagonal_);
+		}
+
+		/**
+		 * Only valid while iterating or after find() returned true. Requires diag_depth == depth.
+		 * @return the value of the entry with all positions set to the current key part
+		 */
+		[[nodiscard]] value_type current_scalar() const noexcept
+			requires(result_depth == 0)
+		{
+			return std::visit([](auto const &raw_hash_diagonal) -> value_type { return raw_hash_diagonal.current_value(); }, raw_hash_diagonal_);
+		}
+
+		/**
+		 * @return if there is a non-zero diagonal for key_part. If so, current_hypertrie() or current_scalar() may be used.
+		 */
+		[[nodiscard]] bool find(key_part_type key_part) noexcept {
+			return std::visit([&](auto &raw_hash_diagonal) { return raw_hash_diagonal.find(key_part); }, raw_hash_diagonal_);
+		}
+
+		StaticHashDiagonal &operator++() noexcept {
+			std::visit([](auto &raw_hash_diagonal) { ++raw_hash_diagonal; }, raw_hash_diagonal_);
+			return *this;
+		}
+
+		[[nodiscard]] bool ended() const noexcept {
+			return std::visit([](auto const &raw_hash_diagonal) { return raw_hash_diagonal.ended(); }, raw_hash_diagonal_);
+		}
+
+		[[nodiscard]] explicit operator bool() const noexcept {
+			return not ended();
+		}
+
+		bool operator==(bool other) const noexcept {
+			return bool(*this) == other;
+		}
+
+		/**
+		 * Returns an upper bound for the number of diagonal slices.
+		 */
+		[[nodiscard]] size_t size() const noexcept {
+			return std::visit([](auto const &raw_hash_diagonal) { return raw_hash_diagonal.size(); }, raw_hash_diagonal_);
+		}
+
+		bool operator<(StaticHashDiagonal const &other) const noexcept {
+			return this->size() < other.size();
+		}
+	};
+
+}// namespace dice::hypertrie
+
+#endif//HYPERTRIE_STATICHYPERTRIE_HPP
@@ -13,6 +13,9 @@
  * To unify it with the other maps use deref().
  */
 
+#include "dice/hypertrie/internal/container/HybridMap.hpp"
+#include "dice/hypertrie/internal/container/HybridSet.hpp"
+#include "dice/hypertrie/internal/container/ShardedMap.hpp"
 #include "dice/hypertrie/internal/container/SparseMap.hpp"
 #include "dice/hypertrie/internal/container/SparseSet.hpp"
 #include "dice/hypertrie/internal/container/StdMap.hpp"
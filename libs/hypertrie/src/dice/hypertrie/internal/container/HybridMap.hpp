@@ -0,0 +1,337 @@
+#ifndef HYPERTRIE_HYBRIDMAP_HPP
+#define HYPERTRIE_HYBRIDMAP_HPP
+
+#include "dice/hypertrie/internal/container/deref_map_iterator.hpp"
+#include "dice/hypertrie/internal/util/SmallKeySearch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace dice::hypertrie::internal::container {
+
+	/**
+	 * A map that stores up to small_capacity entries inline and switches to a map_type_t once it grows beyond that.
+	 * Inline, keys and mapped values are stored in separate arrays that are sorted by key; keys are looked up with util::find_key().
+	 * The inline arrays take at least the space the map object takes anyway (but hold at least min_small_capacity entries),
+	 * so small maps need no further allocation.
+	 *
+	 * The interface is a subset of the interface of the wrapped map. Iterators yield std::pair<Key const &, T const &>.
+	 * Mapped values are changed via deref() or iterator.value().
+	 * A map never switches back to the inline arrays, except when it is copied.
+	 * As with the wrapped maps, inserting invalidates iterators and references. Erasing invalidates iterators to and behind the erased entry.
+	 * @tparam Key key type; must be totally ordered
+	 * @tparam T mapped type
+	 * @tparam Allocator allocator passed to the wrapped map
+	 * @tparam map_type_t type of the wrapped map, with the template parameters <Key, T, Allocator> (see AllContainer.hpp)
+	 * @tparam min_small_capacity minimum number of entries that are stored inline
+	 */
+	template<typename Key, typename T, typename Allocator, template<typename, typename, typename> class map_type_t, size_t min_small_capacity = 4>
+	class HybridMap {
+	public:
+		using key_type = Key;
+		using mapped_type = T;
+		using value_type = std::pair<Key, T>;
+		using size_type = size_t;
+		using allocator_type = Allocator;
+		using big_map_type = map_type_t<Key, T, Allocator>;
+
+		static constexpr size_t small_capacity = std::max(min_small_capacity, sizeof(big_map_type) / (sizeof(Key) + sizeof(T)));
+
+	private:
+		struct SmallMap {
+			std::array<Key, util::padded_key_capacity<Key>(small_capacity)> keys{};
+			std::array<T, small_capacity> values{};
+			uint8_t size = 0;
+		};
+		static_assert(small_capacity <= std::numeric_limits<uint8_t>::max());
+
+		[[no_unique_address]] Allocator alloc_;
+		std::variant<SmallMap, big_map_type> map_;
+
+		/**
+		 * @return index of the first entry with a key not less than key
+		 */
+		static size_t small_lower_bound(SmallMap const &small, Key const &key) noexcept {
+			size_t i = 0;
+			while (i < small.size and small.keys[i] < key)
+				++i;
+			return i;
+		}
+
+		template<bool is_const>
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = std::pair<Key, T>;
+			using reference = std::pair<Key const &, T const &>;
+
+			struct pointer {
+				reference entry;
+				reference const *operator->() const noexcept { return &entry; }
+			};
+
+		private:
+			friend class HybridMap;
+			template<bool>
+			friend class Iterator;
+			using big_iterator = std::conditional_t<is_const, typename big_map_type::const_iterator, typename big_map_type::iterator>;
+			using small_value_pointer = std::conditional_t<is_const, T const *, T *>;
+
+			Key const *small_key_ = nullptr;
+			small_value_pointer small_value_ = nullptr;
+			big_iterator big_{};
+
+			Iterator(Key const *small_key, small_value_pointer small_value) noexcept : small_key_(small_key), small_value_(small_value) {}
+			explicit Iterator(big_iterator big) noexcept : big_(big) {}
+
+		public:
+			Iterator() noexcept = default;
+
+			operator Iterator<true>() const noexcept
+				requires(!is_const)
+			{
+				if (small_key_ != nullptr)
+					return Iterator<true>{small_key_, small_value_};
+				return Iterator<true>{typename big_map_type::const_iterator{big_}};
+			}
+
+			reference operator*() const noexcept {
+				if (small_key_ != nullptr)
+					return {*small_key_, *small_value_};
+				return {big_->first, big_->second};
+			}
+
+			pointer operator->() const noexcept { return {**this}; }
+
+			/**
+			 * Access to the mapped value, see deref().
+			 */
+			auto &value() const noexcept {
+				if (small_key_ != nullptr)
+					return *small_value_;
+				return deref(big_);
+			}
+
+			Iterator &operator++() noexcept {
+				if (small_key_ != nullptr) {
+					++small_key_;
+					++small_value_;
+				} else {
+					++big_;
+				}
+				return *this;
+			}
+
+			Iterator operator++(int) noexcept {
+				auto old = *this;
+				++(*this);
+				return old;
+			}
+
+			bool operator==(Iterator const &other) const noexcept {
+				return small_key_ == other.small_key_ and (small_key_ != nullptr or big_ == other.big_);
+			}
+		};
+
+		template<typename Iter, typename Small>
+		static Iter small_iter(Small &small, size_t i) noexcept {
+			return Iter{small.keys.data() + i, small.values.data() + i};
+		}
+
+	public:
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		explicit HybridMap(Allocator const &alloc = Allocator()) noexcept : alloc_(alloc) {}
+
+		HybridMap(HybridMap const &other) : alloc_(other.alloc_) {
+			if (other.is_small() or other.size() > small_capacity) {
+				map_ = other.map_;
+			} else {
+				// the copy fits inline again
+				std::array<value_type, small_capacity> entries;
+				size_t size = 0;
+				for (auto const &[key, mapped] : other)
+					entries[size++] = {key, mapped};
+				std::sort(entries.begin(), entries.begin() + size,
+						  [](auto const &lhs, auto const &rhs) { return lhs.first < rhs.first; });
+				SmallMap small;
+				for (; small.size < size; ++small.size) {
+					small.keys[small.size] = entries[small.size].first;
+					small.values[small.size] = std::move(entries[small.size].second);
+				}
+				map_ = std::move(small);
+			}
+		}
+
+		HybridMap(HybridMap &&other) noexcept = default;
+		HybridMap &operator=(HybridMap const &other) = default;
+		HybridMap &operator=(HybridMap &&other) noexcept = default;
+
+		/**
+		 * @return true if the entries are stored inline
+		 */
+		[[nodiscard]] bool is_small() const noexcept { return std::holds_alternative<SmallMap>(map_); }
+
+		[[nodiscard]] size_t size() const noexcept {
+			if (is_small())
+				return std::get<SmallMap>(map_).size;
+			return std::get<big_map_type>(map_).size();
+		}
+
+		[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+		iterator begin() noexcept {
+			if (auto *small = std::get_if<SmallMap>(&map_); small != nullptr)
+				return small_iter<iterator>(*small, 0);
+			return iterator{std::get<big_map_type>(map_).begin()};
+		}
+
+		iterator end() noexcept {
+			if (auto *small = std::get_if<SmallMap>(&map_); small != nullptr)
+				return small_iter<iterator>(*small, small->size);
+			return iterator{std::get<big_map_type>(map_).end()};
+		}
+
+		const_iterator begin() const noexcept {
+			if (auto const *small = std::get_if<SmallMap>(&map_); small != nullptr)
+				return small_iter<const_iterator>(*small, 0);
+			return const_iterator{std::get<big_map_type>(map_).begin()};
+		}
+
+		const_iterator end() const noexcept {
+			if (auto const *small = std::get_if<SmallMap>(&map_); small != nullptr)
+				return small_iter<const_iterator>(*small, small->size);
+			return const_iterator{std::get<big_map_type>(map_).end()};
+		}
+
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+
+		iterator find(Key const &key) noexcept {
+			if (auto *small = std::get_if<SmallMap>(&map_); small != nullptr)
+				return small_iter<iterator>(*small, util::find_key(small->keys, small->size, key));
+			return iterator{std::get<big_map_type>(map_).find(key)};
+		}
+
+		const_iterator find(Key const &key) const noexcept {
+			if (auto const *small = std::get_if<SmallMap>(&map_); small != nullptr)
+				return small_iter<const_iterator>(*small, util::find_key(small->keys, small->size, key));
+			return const_iterator{std::get<big_map_type>(map_).find(key)};
+		}
+
+		[[nodiscard]] bool contains(Key const &key) const noexcept { return find(key) != end(); }
+
+		[[nodiscard]] size_t count(Key const &key) const noexcept { return contains(key) ? 1 : 0; }
+
+		/**
+		 * Switches to the wrapped map if more than small_capacity entries are expected.
+		 */
+		void reserve(size_t size) {
+			if (size > small_capacity)
+				promote();
+			if (auto *big = std::get_if<big_map_type>(&map_); big != nullptr) {
+				if constexpr (requires { big->reserve(size); })
+					big->reserve(size);
+			}
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(Key const &key, Args &&...args) {
+			if (auto *small = std::get_if<SmallMap>(&map_); small != nullptr) {
+				auto const i = small_lower_bound(*small, key);
+				if (i < small->size and small->keys[i] == key)
+					return {small_iter<iterator>(*small, i), false};
+				if (small->size < small_capacity) {
+					std::move_backward(small->keys.begin() + i, small->keys.begin() + small->size, small->keys.begin() + small->size + 1);
+					std::move_backward(small->values.begin() + i, small->values.begin() + small->size, small->values.begin() + small->size + 1);
+					small->keys[i] = key;
+					small->values[i] = T(std::forward<Args>(args)...);
+					++small->size;
+					return {small_iter<iterator>(*small, i), true};
+				}
+				promote();
+			}
+			auto [big_iter, inserted] = std::get<big_map_type>(map_).try_emplace(key, std::forward<Args>(args)...);
+			return {iterator{big_iter}, inserted};
+		}
+
+		std::pair<iterator, bool> insert(value_type const &entry) {
+			return try_emplace(entry.first, entry.second);
+		}
+
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(Key const &key, M &&mapped) {
+			auto result = try_emplace(key, std::forward<M>(mapped));
+			if (not result.second)
+				result.first.value() = std::forward<M>(mapped);
+			return result;
+		}
+
+		T &operator[](Key const &key) {
+			return try_emplace(key).first.value();
+		}
+
+		iterator erase(const_iterator pos) noexcept {
+			if (auto *small = std::get_if<SmallMap>(&map_); small != nullptr) {
+				auto const i = static_cast<size_t>(pos.small_key_ - small->keys.data());
+				assert(i < small->size);
+				std::move(small->keys.begin() + i + 1, small->keys.begin() + small->size, small->keys.begin() + i);
+				std::move(small->values.begin() + i + 1, small->values.begin() + small->size, small->values.begin() + i);
+				--small->size;
+				return small_iter<iterator>(*small, i);
+			}
+			return iterator{std::get<big_map_type>(map_).erase(pos.big_)};
+		}
+
+		iterator erase(iterator pos) noexcept {
+			return erase(const_iterator{pos});
+		}
+
+		size_t erase(Key const &key) noexcept {
+			auto found = find(key);
+			if (found == end())
+				return 0;
+			erase(found);
+			return 1;
+		}
+
+		void clear() noexcept {
+			map_ = SmallMap{};
+		}
+
+		[[nodiscard]] bool operator==(HybridMap const &other) const noexcept {
+			if (size() != other.size())
+				return false;
+			return std::all_of(begin(), end(), [&](auto const &entry) {
+				auto found = other.find(entry.first);
+				return found != other.end() and found->second == entry.second;
+			});
+		}
+
+	private:
+		void promote() {
+			auto *small = std::get_if<SmallMap>(&map_);
+			if (small == nullptr)
+				return;
+			big_map_type big(alloc_);
+			if constexpr (requires { big.reserve(small_capacity + 1); })
+				big.reserve(small_capacity + 1);
+			for (size_t i = 0; i < small->size; ++i)
+				big.try_emplace(small->keys[i], std::move(small->values[i]));
+			map_ = std::move(big);
+		}
+	};
+
+}// namespace dice::hypertrie::internal::container
+
+#endif//HYPERTRIE_HYBRIDMAP_HPP
@@ -0,0 +1,241 @@
+#ifndef HYPERTRIE_HYBRIDSET_HPP
+#define HYPERTRIE_HYBRIDSET_HPP
+
+#include "dice/hypertrie/internal/util/SmallKeySearch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace dice::hypertrie::internal::container {
+
+	/**
+	 * A set that stores up to small_capacity keys inline as a sorted array and switches to a set_type_t once it grows beyond that.
+	 * Keys are looked up with util::find_key(). The set counterpart of HybridMap; see there for details.
+	 * @tparam Key key type; must be totally ordered
+	 * @tparam Allocator allocator passed to the wrapped set
+	 * @tparam set_type_t type of the wrapped set, with the template parameters <Key, Allocator> (see AllContainer.hpp)
+	 * @tparam min_small_capacity minimum number of keys that are stored inline
+	 */
+	template<typename Key, typename Allocator, template<typename, typename> class set_type_t, size_t min_small_capacity = 4>
+	class HybridSet {
+	public:
+		using key_type = Key;
+		using value_type = Key;
+		using size_type = size_t;
+		using allocator_type = Allocator;
+		using big_set_type = set_type_t<Key, Allocator>;
+
+		static constexpr size_t small_capacity = std::max(min_small_capacity, sizeof(big_set_type) / sizeof(Key));
+
+	private:
+		struct SmallSet {
+			std::array<Key, util::padded_key_capacity<Key>(small_capacity)> keys{};
+			uint8_t size = 0;
+		};
+		static_assert(small_capacity <= std::numeric_limits<uint8_t>::max());
+
+		[[no_unique_address]] Allocator alloc_;
+		std::variant<SmallSet, big_set_type> set_;
+
+		/**
+		 * @return index of the first key not less than key
+		 */
+		static size_t small_lower_bound(SmallSet const &small, Key const &key) noexcept {
+			size_t i = 0;
+			while (i < small.size and small.keys[i] < key)
+				++i;
+			return i;
+		}
+
+	public:
+		class const_iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = Key;
+			using reference = Key const &;
+			using pointer = Key const *;
+
+		private:
+			friend class HybridSet;
+			using big_iterator = typename big_set_type::const_iterator;
+
+			Key const *small_ = nullptr;
+			big_iterator big_{};
+
+			explicit const_iterator(Key const *small) noexcept : small_(small) {}
+			explicit const_iterator(big_iterator big) noexcept : big_(big) {}
+
+		public:
+			const_iterator() noexcept = default;
+
+			reference operator*() const noexcept {
+				if (small_ != nullptr)
+					return *small_;
+				return *big_;
+			}
+
+			pointer operator->() const noexcept { return &**this; }
+
+			const_iterator &operator++() noexcept {
+				if (small_ != nullptr)
+					++small_;
+				else
+					++big_;
+				return *this;
+			}
+
+			const_iterator operator++(int) noexcept {
+				auto old = *this;
+				++(*this);
+				return old;
+			}
+
+			bool operator==(const_iterator const &other) const noexcept {
+				return small_ == other.small_ and (small_ != nullptr or big_ == other.big_);
+			}
+		};
+
+		// keys must not be changed in place
+		using iterator = const_iterator;
+
+		explicit HybridSet(Allocator const &alloc = Allocator()) noexcept : alloc_(alloc) {}
+
+		HybridSet(HybridSet const &other) : alloc_(other.alloc_) {
+			if (other.is_small() or other.size() > small_capacity) {
+				set_ = other.set_;
+			} else {
+				// the copy fits inline again
+				SmallSet small;
+				for (auto const &key : other)
+					small.keys[small.size++] = key;
+				std::sort(small.keys.begin(), small.keys.begin() + small.size);
+				set_ = small;
+			}
+		}
+
+		HybridSet(HybridSet &&other) noexcept = default;
+		HybridSet &operator=(HybridSet const &other) = default;
+		HybridSet &operator=(HybridSet &&other) noexcept = default;
+
+		/**
+		 * @return true if the keys are stored inline
+		 */
+		[[nodiscard]] bool is_small() const noexcept { return std::holds_alternative<SmallSet>(set_); }
+
+		[[nodiscard]] size_t size() const noexcept {
+			if (is_small())
+				return std::get<SmallSet>(set_).size;
+			return std::get<big_set_type>(set_).size();
+		}
+
+		[[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+		const_iterator begin() const noexcept {
+			if (is_small())
+				return const_iterator{std::get<SmallSet>(set_).keys.data()};
+			return const_iterator{std::get<big_set_type>(set_).begin()};
+		}
+
+		const_iterator end() const noexcept {
+			if (auto const *small = std::get_if<SmallSet>(&set_); small != nullptr)
+				return const_iterator{small->keys.data() + small->size};
+			return const_iterator{std::get<big_set_type>(set_).end()};
+		}
+
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+
+		const_iterator find(Key const &key) const noexcept {
+			if (auto const *small = std::get_if<SmallSet>(&set_); small != nullptr)
+				return const_iterator{small->keys.data() + util::find_key(small->keys, small->size, key)};
+			return const_iterator{std::get<big_set_type>(set_).find(key)};
+		}
+
+		[[nodiscard]] bool contains(Key const &key) const noexcept { return find(key) != end(); }
+
+		[[nodiscard]] size_t count(Key const &key) const noexcept { return contains(key) ? 1 : 0; }
+
+		/**
+		 * Switches to the wrapped set if more than small_capacity keys are expected.
+		 */
+		void reserve(size_t size) {
+			if (size > small_capacity)
+				promote();
+			if (auto *big = std::get_if<big_set_type>(&set_); big != nullptr) {
+				if constexpr (requires { big->reserve(size); })
+					big->reserve(size);
+			}
+		}
+
+		std::pair<const_iterator, bool> insert(Key const &key) {
+			if (auto *small = std::get_if<SmallSet>(&set_); small != nullptr) {
+				auto const i = small_lower_bound(*small, key);
+				if (i < small->size and small->keys[i] == key)
+					return {const_iterator{small->keys.data() + i}, false};
+				if (small->size < small_capacity) {
+					std::move_backward(small->keys.begin() + i, small->keys.begin() + small->size, small->keys.begin() + small->size + 1);
+					small->keys[i] = key;
+					++small->size;
+					return {const_iterator{small->keys.data() + i}, true};
+				}
+				promote();
+			}
+			auto [big_iter, inserted] = std::get<big_set_type>(set_).insert(key);
+			return {const_iterator{big_iter}, inserted};
+		}
+
+		const_iterator erase(const_iterator pos) noexcept {
+			if (auto *small = std::get_if<SmallSet>(&set_); small != nullptr) {
+				auto const i = static_cast<size_t>(pos.small_ - small->keys.data());
+				assert(i < small->size);
+				std::move(small->keys.begin() + i + 1, small->keys.begin() + small->size, small->keys.begin() + i);
+				--small->size;
+				return const_iterator{small->keys.data() + i};
+			}
+			return const_iterator{std::get<big_set_type>(set_).erase(pos.big_)};
+		}
+
+		size_t erase(Key const &key) noexcept {
+			auto found = find(key);
+			if (found == end())
+				return 0;
+			erase(found);
+			return 1;
+		}
+
+		void clear() noexcept {
+			set_ = SmallSet{};
+		}
+
+		[[nodiscard]] bool operator==(HybridSet const &other) const noexcept {
+			if (size() != other.size())
+				return false;
+			return std::all_of(begin(), end(), [&](Key const &key) { return other.contains(key); });
+		}
+
+	private:
+		void promote() {
+			auto *small = std::get_if<SmallSet>(&set_);
+			if (small == nullptr)
+				return;
+			big_set_type big(alloc_);
+			if constexpr (requires { big.reserve(small_capacity + 1); })
+				big.reserve(small_capacity + 1);
+			for (size_t i = 0; i < small->size; ++i)
+				big.insert(small->keys[i]);
+			set_ = std::move(big);
+		}
+	};
+
+}// namespace dice::hypertrie::internal::container
+
+#endif//HYPERTRIE_HYBRIDSET_HPP
@@ -0,0 +1,296 @@
+#ifndef HYPERTRIE_SHARDEDMAP_HPP
+#define HYPERTRIE_SHARDEDMAP_HPP
+
+#include "dice/hypertrie/internal/container/deref_map_iterator.hpp"
+
+#include <dice/hash/DiceHash.hpp>
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <utility>
+
+namespace dice::hypertrie::internal::container {
+
+	/**
+	 * A map that is split into shards, each an independent map_type_t with its own lock.
+	 * The shard of a key is chosen by the highest bits of its hash (below the most significant bit, which is used for tagging identifiers),
+	 * so the bits the shard maps use for bucketing are not correlated with the shard.
+	 *
+	 * The interface of the shard maps is provided for the map as a whole. Modifications lock the affected shard exclusively and
+	 * lookups lock it shared. So, any number of threads can modify different or the same shards concurrently.
+	 * Iterators and references into a shard are only stable as long as no other thread modifies that shard.
+	 * Threads that read while others write must use find_value(), which copies the mapped value while holding the lock.
+	 * Iterating the whole map is not synchronized at all.
+	 *
+	 * @tparam Key key type
+	 * @tparam T mapped type
+	 * @tparam Allocator allocator passed to the shard maps
+	 * @tparam map_type_t type of the shard maps, with the template parameters <Key, T, Allocator> (see AllContainer.hpp)
+	 * @tparam shards number of shards; must be a power of two
+	 */
+	template<typename Key, typename T, typename Allocator, template<typename, typename, typename> class map_type_t, size_t shards>
+	class ShardedMap {
+		static_assert(shards > 0 and std::has_single_bit(shards), "The number of shards must be a power of two.");
+
+	public:
+		using shard_map_type = map_type_t<Key, T, Allocator>;
+		using key_type = Key;
+		using mapped_type = T;
+		using size_type = size_t;
+		using allocator_type = Allocator;
+
+	private:
+		static constexpr size_t shard_bits = std::bit_width(shards) - 1;
+		static constexpr size_t shard_shift = (shard_bits == 0) ? 0 : 63 - shard_bits;
+
+		struct Shard {
+			shard_map_type map;
+			mutable std::shared_mutex mutex;
+
+			explicit Shard(Allocator const &alloc) : map(alloc) {}
+			Shard(Shard &&other) noexcept : map(std::move(other.map)) {}
+		};
+
+		std::array<Shard, shards> shards_;
+
+		template<size_t... IDs>
+		static std::array<Shard, shards> make_shards(Allocator const &alloc, std::index_sequence<IDs...>) {
+			return {((void) IDs, Shard{alloc})...};
+		}
+
+		template<size_t... IDs>
+		static std::array<Shard, shards> move_shards(std::array<Shard, shards> &other, std::index_sequence<IDs...>) {
+			return {Shard{std::move(other[IDs])}...};
+		}
+
+		Shard &shard_for(Key const &key) noexcept { return shards_[shard_of(key)]; }
+		Shard const &shard_for(Key const &key) const noexcept { return shards_[shard_of(key)]; }
+
+		template<bool is_const>
+		class Iterator {
+			friend class ShardedMap;
+			using shards_type = std::conditional_t<is_const, std::array<Shard, shards> const, std::array<Shard, shards>>;
+			using inner_iterator = std::conditional_t<is_const, typename shard_map_type::const_iterator, typename shard_map_type::iterator>;
+
+			shards_type *shards_ = nullptr;
+			size_t shard_ = shards;
+			inner_iterator inner_{};
+
+			Iterator(shards_type *shards_ptr, size_t shard, inner_iterator inner) noexcept
+				: shards_(shards_ptr), shard_(shard), inner_(inner) {
+				skip_exhausted_shards();
+			}
+
+			void skip_exhausted_shards() noexcept {
+				while (shard_ < shards and inner_ == (*shards_)[shard_].map.end()) {
+					++shard_;
+					if (shard_ < shards)
+						inner_ = (*shards_)[shard_].map.begin();
+				}
+			}
+
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using difference_type = std::ptrdiff_t;
+			using value_type = typename std::iterator_traits<inner_iterator>::value_type;
+			using reference = typename std::iterator_traits<inner_iterator>::reference;
+			using pointer = typename std::iterator_traits<inner_iterator>::pointer;
+
+			Iterator() noexcept = default;
+
+			operator Iterator<true>() const noexcept
+				requires(!is_const)
+			{
+				return Iterator<true>{shards_, shard_, inner_};
+			}
+
+			decltype(auto) operator*() const noexcept { return *inner_; }
+			decltype(auto) operator->() const noexcept { return inner_.operator->(); }
+
+			/**
+			 * Access to the mapped value, see deref().
+			 */
+			decltype(auto) value() const noexcept {
+				if constexpr (is_const)
+					return std::as_const(deref(inner_));
+				else
+					return deref(inner_);
+			}
+
+			Iterator &operator++() noexcept {
+				++inner_;
+				skip_exhausted_shards();
+				return *this;
+			}
+
+			Iterator operator++(int) noexcept {
+				auto old = *this;
+				++(*this);
+				return old;
+			}
+
+			bool operator==(Iterator const &other) const noexcept {
+				return shard_ == other.shard_ and (shard_ == shards or inner_ == other.inner_);
+			}
+		};
+
+	public:
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		explicit ShardedMap(Allocator const &alloc = Allocator()) : shards_(make_shards(alloc, std::make_index_sequence<shards>{})) {}
+
+		ShardedMap(ShardedMap &&other) noexcept : shards_(move_shards(other.shards_, std::make_index_sequence<shards>{})) {}
+
+		ShardedMap(ShardedMap const &) = delete;
+		ShardedMap &operator=(ShardedMap const &) = delete;
+		ShardedMap &operator=(ShardedMap &&) = delete;
+
+		/**
+		 * @param key a key
+		 * @return the index of the shard that holds key
+		 */
+		[[nodiscard]] static size_t shard_of(Key const &key) noexcept {
+			if constexpr (shards == 1) {
+				return 0;
+			} else {
+				return (dice::hash::DiceHash<Key>{}(key) >> shard_shift) & (shards - 1);
+			}
+		}
+
+		/**
+		 * Lock the shard of key exclusively, e.g., to do several operations on it atomically.
+		 */
+		[[nodiscard]] std::unique_lock<std::shared_mutex> lock_shard(Key const &key) const {
+			return std::unique_lock{shard_for(key).mutex};
+		}
+
+		/**
+		 * Thread-safe lookup.
+		 * @param key key to look up
+		 * @return a copy of the value mapped to key or std::nullopt if there is none
+		 */
+		[[nodiscard]] std::optional<T> find_value(Key const &key) const {
+			auto const &shard = shard_for(key);
+			std::shared_lock lock{shard.mutex};
+			auto found = shard.map.find(key);
+			if (found == shard.map.end())
+				return std::nullopt;
+			return found->second;
+		}
+
+		iterator begin() noexcept { return iterator{&shards_, 0, shards_[0].map.begin()}; }
+		iterator end() noexcept { return iterator{}; }
+		const_iterator begin() const noexcept { return const_iterator{&shards_, 0, shards_[0].map.begin()}; }
+		const_iterator end() const noexcept { return const_iterator{}; }
+		const_iterator cbegin() const noexcept { return begin(); }
+		const_iterator cend() const noexcept { return end(); }
+
+		iterator find(Key const &key) {
+			auto const shard_id = shard_of(key);
+			auto &shard = shards_[shard_id];
+			std::shared_lock lock{shard.mutex};
+			auto found = shard.map.find(key);
+			return (found == shard.map.end()) ? end() : iterator{&shards_, shard_id, found};
+		}
+
+		const_iterator find(Key const &key) const {
+			auto const shard_id = shard_of(key);
+			auto const &shard = shards_[shard_id];
+			std::shared_lock lock{shard.mutex};
+			auto found = shard.map.find(key);
+			return (found == shard.map.end()) ? end() : const_iterator{&shards_, shard_id, found};
+		}
+
+		[[nodiscard]] bool contains(Key const &key) const {
+			auto const &shard = shard_for(key);
+			std::shared_lock lock{shard.mutex};
+			return shard.map.find(key) != shard.map.end();
+		}
+
+		[[nodiscard]] size_t count(Key const &key) const { return contains(key) ? 1 : 0; }
+
+		T const &at(Key const &key) const {
+			auto const &shard = shard_for(key);
+			std::shared_lock lock{shard.mutex};
+			return shard.map.at(key);
+		}
+
+		T &at(Key const &key) {
+			auto &shard = shard_for(key);
+			std::shared_lock lock{shard.mutex};
+			auto found = shard.map.find(key);
+			if (found == shard.map.end())
+				throw std::out_of_range{"key not found"};
+			return deref(found);
+		}
+
+		T &operator[](Key const &key) {
+			auto &shard = shard_for(key);
+			std::unique_lock lock{shard.mutex};
+			return shard.map[key];
+		}
+
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Key const &key, Args &&...args) {
+			auto const shard_id = shard_of(key);
+			auto &shard = shards_[shard_id];
+			std::unique_lock lock{shard.mutex};
+			auto [inner, inserted] = shard.map.emplace(key, std::forward<Args>(args)...);
+			return {iterator{&shards_, shard_id, inner}, inserted};
+		}
+
+		template<typename Value>
+		std::pair<iterator, bool> insert(Value &&value) {
+			return emplace(value.first, std::forward<Value>(value).second);
+		}
+
+		/**
+		 * The hint is ignored. Provided for compatibility with the shard maps.
+		 */
+		template<typename Value>
+		iterator insert([[maybe_unused]] const_iterator hint, Value &&value) {
+			return insert(std::forward<Value>(value)).first;
+		}
+
+		iterator erase(const_iterator pos) {
+			auto const shard_id = pos.shard_;
+			auto &shard = shards_[shard_id];
+			std::unique_lock lock{shard.mutex};
+			return iterator{&shards_, shard_id, shard.map.erase(pos.inner_)};
+		}
+
+		size_t erase(Key const &key) {
+			auto &shard = shard_for(key);
+			std::unique_lock lock{shard.mutex};
+			return shard.map.erase(key);
+		}
+
+		[[nodiscard]] size_t size() const noexcept {
+			size_t size = 0;
+			for (auto const &shard : shards_)
+				size += shard.map.size();
+			return size;
+		}
+
+		[[nodiscard]] bool empty() const noexcept {
+			return size() == 0;
+		}
+
+		void clear() noexcept {
+			for (auto &shard : shards_) {
+				std::unique_lock lock{shard.mutex};
+				shard.map.clear();
+			}
+		}
+	};
+
+}// namespace dice::hypertrie::internal::container
+
+#endif//HYPERTRIE_SHARDEDMAP_HPP
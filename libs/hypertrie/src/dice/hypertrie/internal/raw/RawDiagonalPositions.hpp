@@ -3,11 +3,14 @@
 
 #include "dice/hypertrie/internal/raw/RawKey.hpp"
 
+#include <algorithm>
+
 namespace dice::hypertrie::internal::raw {
 
 	template<size_t depth>
 	class RawKeyPositions {
-		static_assert(depth < 8);
+		// positions are passed as uint8_t
+		static_assert(depth <= 256);
 		static constexpr size_t bytes = (depth > 0) ? depth / 8U + 1U : 0;
 		std::array<std::byte, bytes> data_{};
 
@@ -30,6 +33,16 @@ namespace dice::hypertrie::internal::raw {
 				set_true(pos);
 		}
 
+		/**
+		 * Copies the positions of other that are smaller than depth.
+		 */
+		template<size_t other_depth>
+		explicit RawKeyPositions(RawKeyPositions<other_depth> const &other) noexcept {
+			for (size_t pos = 0; pos < std::min(depth, other_depth); ++pos)
+				if (other[pos])
+					set_true(pos);
+		}
+
 		bool operator[](size_t pos) const noexcept {
 			assert(pos < depth);
 			size_t byte_id = pos / 8;
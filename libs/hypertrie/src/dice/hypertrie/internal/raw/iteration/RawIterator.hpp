@@ -62,7 +62,7 @@ namespace dice::hypertrie::internal::raw {
 					// copy the key of the compressed child node to the iterator key
 					std::copy(sen_key.cbegin(), sen_key.cend(), value_.key().begin());
 					if constexpr (not HypertrieTrait_bool_valued<htt_t>)
-						value_.value() = sen_ptr->value();
+						write_value(sen_ptr->value());
 				}
 			}
 		}
@@ -94,6 +94,13 @@ namespace dice::hypertrie::internal::raw {
 		}
 
 	protected:
+		void write_value(typename htt_t::value_type value) noexcept {
+			if constexpr (use_raw_key)
+				value_.value() = value;
+			else
+				value_.value(value);
+		}
+
 		template<size_t current_depth>
 		void init_fn_rek(FNContainer<current_depth, htt_t, allocator_type> const &nodec) noexcept {
 			active_iter_ = current_depth;
@@ -140,7 +147,7 @@ namespace dice::hypertrie::internal::raw {
 				// copy the key of the compressed child node to the iterator key
 				std::copy(sen_key.cbegin(), sen_key.cend(), value_.key().begin());
 				if constexpr (not HypertrieTrait_bool_valued<htt_t>)
-					value_.value() = sen_ptr->value();
+					write_value(sen_ptr->value());
 			}
 		}
 
@@ -164,7 +171,7 @@ namespace dice::hypertrie::internal::raw {
 
 			// write value
 			if constexpr (node_depth == 1 and not HypertrieTrait_bool_valued<htt_t>)
-				value_.value() = iter->second;
+				write_value(iter->second);
 		}
 
 
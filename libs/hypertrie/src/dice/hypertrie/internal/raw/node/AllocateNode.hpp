@@ -3,6 +3,7 @@
 
 #include "dice/hypertrie/Hypertrie_trait.hpp"
 #include "dice/hypertrie/hypertrie_allocator_trait.hpp"
+#include "dice/hypertrie/internal/raw/node/NodeSlab.hpp"
 #include "dice/hypertrie/internal/raw/node/NodeTypes_reflection.hpp"
 #include <memory>
 
@@ -14,6 +15,7 @@ namespace dice::hypertrie::internal::raw {
 	 * You can use the new_() and delete_() methods exactly how you would use the new and delete commands inside c++.
 	 * new_with_alloc() will construct an object and pass the allocator into the constructor of that object.
 	 * This is useful if the created object should use the same allocator.
+	 * Storage for the nodes is taken from a NodeSlab, i.e. nodes are allocated in chunks and the storage of deleted nodes is reused.
 	 */
 	template<size_t depth, HypertrieTrait htt_t, template<size_t, typename, typename> typename node_type_t, ByteAllocator allocator_type>
 	class AllocateNode {
@@ -21,13 +23,15 @@ namespace dice::hypertrie::internal::raw {
 		using node_type = node_type_t<depth, htt_t, allocator_type>;
 		using cn_allocator_type = typename std::allocator_traits<allocator_type>::template rebind_alloc<node_type>;
 		using cn_allocator_traits = typename std::allocator_traits<cn_allocator_type>;
-		using pointer = typename cn_allocator_traits::pointer;
+		using slab_type = NodeSlab<node_type, allocator_type>;
+		using pointer = typename slab_type::pointer;
 
 	private:
 		cn_allocator_type allocator_;
+		slab_type slab_;
 
-		[[nodiscard]] pointer allocate(size_t n) {
-			return cn_allocator_traits::allocate(allocator_, n);
+		[[nodiscard]] pointer allocate() {
+			return slab_.allocate();
 		}
 		template<typename... Args>
 		void construct(pointer ptr, Args &&...args) {
@@ -37,30 +41,30 @@ namespace dice::hypertrie::internal::raw {
 			cn_allocator_traits::destroy(allocator_, std::to_address(ptr));
 		}
 
-		void deallocate(pointer ptr, size_t n) {
-			cn_allocator_traits::deallocate(allocator_, ptr, n);
+		void deallocate(pointer ptr) {
+			slab_.deallocate(ptr);
 		}
 
 	public:
-		explicit AllocateNode(allocator_type const &alloc) : allocator_(alloc) {}
+		explicit AllocateNode(allocator_type const &alloc) : allocator_(alloc), slab_(alloc) {}
 
 		template<typename... Args>
 		pointer new_(Args &&...args) {
-			pointer ptr = allocate(1);
+			pointer ptr = allocate();
 			construct(ptr, std::forward<Args>(args)...);
 			return ptr;
 		}
 
 		template<typename... Args>
 		pointer new_with_alloc(Args &&...args) {
-			pointer ptr = allocate(1);
+			pointer ptr = allocate();
 			construct(ptr, std::forward<Args>(args)..., allocator_);
 			return ptr;
 		}
 
 		void delete_(pointer to_erase) {
 			destroy(to_erase);
-			deallocate(to_erase, 1);
+			deallocate(to_erase);
 		}
 	};
 
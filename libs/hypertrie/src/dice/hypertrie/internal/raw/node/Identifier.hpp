@@ -5,6 +5,8 @@
 #include "dice/hypertrie/internal/raw/node/SingleEntry.hpp"
 #include "dice/hypertrie/internal/util/UnsafeCast.hpp"
 
+#include <span>
+
 namespace dice::hash {
 	template<typename Policy, size_t depth, ::dice::hypertrie::HypertrieTrait htt_t>
 	struct dice_hash_overload<Policy, ::dice::hypertrie::internal::raw::SingleEntry<depth, htt_t>> {
@@ -154,8 +156,17 @@ namespace dice::hypertrie::internal::raw {
 		 * @return the combined hash
 		 */
 		[[nodiscard]] static size_t hash_and_combine(Entry const &entry, size_t seed = seed_) noexcept {
-			using EntryHash = dice::hash::DiceHashMartinus<Entry>;
-			return EntryHash::hash_invertible_combine({seed, EntryHash()(entry)});
+			return combine_entry_hash(entry_hash(entry), seed);
+		}
+
+		/**
+		 * Like hash_and_combine but with the hash of the entry already computed.
+		 * @param entry_hash the hash of an entry (see entry_hash)
+		 * @param seed the seed to be combined with
+		 * @return the combined hash
+		 */
+		[[nodiscard]] static size_t combine_entry_hash(size_t entry_hash, size_t seed = seed_) noexcept {
+			return dice::hash::DiceHashMartinus<Entry>::hash_invertible_combine({seed, entry_hash});
 		}
 
 
@@ -180,6 +191,24 @@ namespace dice::hypertrie::internal::raw {
 			return tag_as_fn(hash);
 		}
 
+		static size_t hash_hashed_entries(std::span<Entry const> entries, std::span<size_t const> entry_hashes) noexcept {
+			assert(entries.size() == entry_hashes.size());
+			if (entries.empty())
+				return seed_;
+
+			if (entries.size() == 1UL) {
+				if constexpr (in_place_node)
+					return encode_single_entry(entries[0]);
+				else
+					return tag_as_sen(combine_entry_hash(entry_hashes[0]));
+			}
+
+			size_t hash = seed_;
+			for (auto const entry_hash : entry_hashes)
+				hash = combine_entry_hash(entry_hash, hash);
+			return tag_as_fn(hash);
+		}
+
 		explicit RawIdentifier(size_t hash) noexcept : super_t{hash} {}
 		friend Identifier<htt_t>;
 
@@ -203,6 +232,24 @@ namespace dice::hypertrie::internal::raw {
 		 */
 		RawIdentifier(std::initializer_list<Entry> entries) noexcept : super_t(hash_iterable(entries)) {}
 
+		/**
+		 * Constructs an RawIdentifier for a node represented by the entries provided whose hashes were computed before.
+		 * The result is the same as for RawIdentifier(entries), but the entries are not hashed again.
+		 * @param entries MUST NOT contain duplicates. This is not checked. The caller is responsible to eliminate duplicates beforehand.
+		 * @param entry_hashes entry_hash(entries[i]) for each i
+		 */
+		RawIdentifier(std::span<Entry const> entries, std::span<size_t const> entry_hashes) noexcept : super_t(hash_hashed_entries(entries, entry_hashes)) {}
+
+		/**
+		 * The hash of a single entry as it is combined into identifiers. Callers that need the identifier of an entry set more than once
+		 * (e.g., first for deduplicating entries and then for updating a node) can compute the hashes once and pass them along with the entries.
+		 * @param entry the entry to hash
+		 * @return hash of entry
+		 */
+		[[nodiscard]] static size_t entry_hash(Entry const &entry) noexcept {
+			return dice::hash::DiceHashMartinus<Entry>()(entry);
+		}
+
 		/**
 		 * Changes the value of an entry.<br/>
 		 * The caller is responsible to guarantee that old_entry is an entry of the node this identifies.
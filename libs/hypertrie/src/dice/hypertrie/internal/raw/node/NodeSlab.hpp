@@ -0,0 +1,159 @@
+#ifndef HYPERTRIE_NODESLAB_HPP
+#define HYPERTRIE_NODESLAB_HPP
+
+#include "dice/hypertrie/ByteAllocator.hpp"
+#include "dice/hypertrie/hypertrie_allocator_trait.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace dice::hypertrie::internal::raw {
+
+	/**
+	 * Size-class slab for objects of a single type T.
+	 * Storage is requested from the allocator in chunks of many slots instead of one allocation per object.
+	 * Slots that are given back are kept in an intrusive free list and are reused before fresh slots are taken from the current chunk.
+	 * All bookkeeping is done with the allocator's (possibly fancy) pointer type, so a slab can live in persistent memory (e.g. metall).
+	 * The slab only hands out and takes back raw storage. Constructing and destroying objects is up to the caller.
+	 * @tparam T type of the objects the slots are sized for
+	 * @tparam allocator_type allocator the chunks are requested from
+	 */
+	template<typename T, ByteAllocator allocator_type>
+	class NodeSlab {
+		using ht_allocator_trait = hypertrie_allocator_trait<allocator_type>;
+
+		struct Slot;
+		using slot_pointer = typename ht_allocator_trait::template pointer<Slot>;
+
+		/**
+		 * Overlay of a slot that is in the free list.
+		 */
+		struct FreeSlot {
+			slot_pointer next;
+		};
+
+		/**
+		 * Overlay of the first slot(s) of a chunk.
+		 */
+		struct ChunkHeader {
+			slot_pointer next_chunk;
+			size_t size;// in slots, including the header slots
+		};
+
+		static constexpr size_t slot_size = std::max(sizeof(T), sizeof(FreeSlot));
+		static constexpr size_t slot_alignment = std::max({alignof(T), alignof(FreeSlot), alignof(ChunkHeader)});
+
+		struct alignas(slot_alignment) Slot {
+			std::byte bytes[slot_size];
+		};
+
+		using slot_allocator_type = typename ht_allocator_trait::template rebind_alloc<Slot>;
+		using slot_allocator_traits = std::allocator_traits<slot_allocator_type>;
+
+	public:
+		using pointer = typename ht_allocator_trait::template pointer<T>;
+
+		/**
+		 * Number of slots in the first chunk. Every further chunk doubles the number of slots up to max_chunk_slots.
+		 */
+		static constexpr size_t min_chunk_slots = 16;
+		/**
+		 * Upper bound for the number of slots in a chunk (chunks of roughly 1 MiB).
+		 */
+		static constexpr size_t max_chunk_slots = std::max(min_chunk_slots, (size_t(1) << 20) / sizeof(Slot));
+
+	private:
+		static constexpr size_t header_slots = (sizeof(ChunkHeader) + sizeof(Slot) - 1) / sizeof(Slot);
+
+		slot_allocator_type slot_alloc_;
+		slot_pointer free_list_{};
+		slot_pointer chunks_{};
+		slot_pointer bump_{};
+		slot_pointer bump_end_{};
+		size_t next_chunk_slots_ = min_chunk_slots;
+
+		void add_chunk() {
+			size_t const chunk_size = header_slots + next_chunk_slots_;
+			slot_pointer chunk = slot_allocator_traits::allocate(slot_alloc_, chunk_size);
+			::new (static_cast<void *>(std::to_address(chunk))) ChunkHeader{chunks_, chunk_size};
+			chunks_ = chunk;
+			bump_ = chunk + header_slots;
+			bump_end_ = chunk + chunk_size;
+			next_chunk_slots_ = std::min(next_chunk_slots_ * 2, max_chunk_slots);
+		}
+
+		void release_chunks() noexcept {
+			while (chunks_) {
+				auto *header = reinterpret_cast<ChunkHeader *>(std::to_address(chunks_));
+				slot_pointer chunk = chunks_;
+				size_t const chunk_size = header->size;
+				chunks_ = header->next_chunk;
+				std::destroy_at(header);
+				slot_allocator_traits::deallocate(slot_alloc_, chunk, chunk_size);
+			}
+			free_list_ = nullptr;
+			bump_ = nullptr;
+			bump_end_ = nullptr;
+			next_chunk_slots_ = min_chunk_slots;
+		}
+
+	public:
+		explicit NodeSlab(allocator_type const &alloc) : slot_alloc_(alloc) {}
+
+		NodeSlab(NodeSlab const &) = delete;
+		NodeSlab &operator=(NodeSlab const &) = delete;
+
+		NodeSlab(NodeSlab &&other) noexcept
+			: slot_alloc_(std::move(other.slot_alloc_)),
+			  free_list_(std::exchange(other.free_list_, nullptr)),
+			  chunks_(std::exchange(other.chunks_, nullptr)),
+			  bump_(std::exchange(other.bump_, nullptr)),
+			  bump_end_(std::exchange(other.bump_end_, nullptr)),
+			  next_chunk_slots_(std::exchange(other.next_chunk_slots_, min_chunk_slots)) {}
+
+		NodeSlab &operator=(NodeSlab &&) = delete;
+
+		/**
+		 * Releases all chunks. Objects still living in the slab are not destroyed.
+		 */
+		~NodeSlab() noexcept {
+			release_chunks();
+		}
+
+		/**
+		 * Takes a slot from the free list or, if it is empty, from the current chunk.
+		 * @return uninitialized storage for one T
+		 */
+		[[nodiscard]] pointer allocate() {
+			slot_pointer slot;
+			if (free_list_) {
+				slot = free_list_;
+				auto *free_slot = reinterpret_cast<FreeSlot *>(std::to_address(slot));
+				free_list_ = free_slot->next;
+				std::destroy_at(free_slot);
+			} else {
+				if (bump_ == bump_end_)
+					add_chunk();
+				slot = bump_;
+				++bump_;
+			}
+			return std::pointer_traits<pointer>::pointer_to(*reinterpret_cast<T *>(std::to_address(slot)));
+		}
+
+		/**
+		 * Puts the slot of ptr into the free list. The object at ptr must have been destroyed before.
+		 * @param ptr pointer previously returned by allocate()
+		 */
+		void deallocate(pointer ptr) noexcept {
+			auto *slot = reinterpret_cast<Slot *>(std::to_address(ptr));
+			::new (static_cast<void *>(slot)) FreeSlot{free_list_};
+			free_list_ = std::pointer_traits<slot_pointer>::pointer_to(*slot);
+		}
+	};
+
+}// namespace dice::hypertrie::internal::raw
+
+#endif//HYPERTRIE_NODESLAB_HPP
@@ -106,11 +106,16 @@ namespace dice::hypertrie::internal::raw {
 		template<size_t depth, template<size_t, typename, typename> typename node_type>
 		[[nodiscard]] SpecificNodePtr<depth, node_type> lookup(RawIdentifier<depth, htt_t> identifier) const noexcept {
 			auto &nodes_ = this->nodes<depth, node_type>().nodes();
-			auto found = nodes_.find(identifier);
-			if (found != nodes_.end()) {
-				return found->second;
+			if constexpr (SpecificNodes<depth, node_type>::is_sharded) {
+				// copy the pointer while the shard is locked
+				return nodes_.find_value(identifier).value_or(SpecificNodePtr<depth, node_type>{});
+			} else {
+				auto found = nodes_.find(identifier);
+				if (found != nodes_.end()) {
+					return found->second;
+				}
+				return {};
 			}
-			return {};
 		}
 
 		/**
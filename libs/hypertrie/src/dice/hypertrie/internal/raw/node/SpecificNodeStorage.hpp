@@ -3,6 +3,7 @@
 
 #include "dice/hypertrie/Hypertrie_trait.hpp"
 #include "dice/hypertrie/hypertrie_allocator_trait.hpp"
+#include "dice/hypertrie/internal/container/ShardedMap.hpp"
 #include "dice/hypertrie/internal/raw/node/AllocateNode.hpp"
 #include "dice/hypertrie/internal/raw/node/Identifier.hpp"
 #include "dice/hypertrie/internal/raw/node/NodeTypes_reflection.hpp"
@@ -21,7 +22,13 @@ namespace dice::hypertrie::internal::raw {
 		using key_type = RawIdentifier<depth, htt_t>;
 		using node_type = node_type_t<depth, htt_t, allocator_type>;
 		using node_pointer_type = typename ht_allocator_trait::template pointer<node_type>;
-		using Map_t = typename htt_t::template map_type<key_type, node_pointer_type, allocator_type>;
+		/**
+		 * If htt_t::node_storage_shards > 1, the nodes are distributed over that many maps, each guarded by its own lock.
+		 */
+		static constexpr bool is_sharded = htt_t::node_storage_shards > 1;
+		using Map_t = std::conditional_t<is_sharded,
+										 container::ShardedMap<key_type, node_pointer_type, allocator_type, htt_t::template map_type, htt_t::node_storage_shards>,
+										 typename htt_t::template map_type<key_type, node_pointer_type, allocator_type>>;
 
 	private:
 		AllocateNode_t allocate_node_;
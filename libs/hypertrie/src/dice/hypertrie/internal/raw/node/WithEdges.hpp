@@ -4,12 +4,16 @@
 #include "dice/hypertrie/ByteAllocator.hpp"
 #include "dice/hypertrie/Hypertrie_trait.hpp"
 #include "dice/hypertrie/hypertrie_allocator_trait.hpp"
+#include "dice/hypertrie/internal/container/HybridMap.hpp"
+#include "dice/hypertrie/internal/container/HybridSet.hpp"
 #include "dice/hypertrie/internal/raw/RawDiagonalPositions.hpp"
 #include "dice/hypertrie/internal/raw/node/Identifier.hpp"
 
 #include "dice/hypertrie/internal/commons/PosType.hpp"
 
 #include <limits>
+#include <span>
+#include <vector>
 
 namespace dice::hypertrie::internal::raw {
 
@@ -27,9 +31,10 @@ namespace dice::hypertrie::internal::raw {
 													typename ht_allocator_trait::template rebind_alloc<std::pair<typename htt_t::key_part_type, ChildType>>>;
 
 		// allocator might need to be cast to specific type for set/map
+		// small children sets are stored inline as sorted arrays and only moved into a set/map when they grow (see HybridMap)
 		using ChildrenType = std::conditional_t<((depth == 1) and htt_t::is_bool_valued),
-												typename htt_t::template set_type<key_part_type, collection_alloc>,
-												typename htt_t::template map_type<typename htt_t::key_part_type, ChildType, collection_alloc>>;
+												container::HybridSet<key_part_type, collection_alloc, htt_t::template set_type>,
+												container::HybridMap<key_part_type, ChildType, collection_alloc, htt_t::template map_type>>;
 
 		using EdgesType = std::conditional_t<(depth > 1),
 											 std::array<ChildrenType, depth>,
@@ -173,13 +178,23 @@ namespace dice::hypertrie::internal::raw {
 			return cards;
 		}
 
-		[[nodiscard]] std::vector<size_t> getCards(std::vector<pos_type> const &positions) const noexcept {
-			std::vector<size_t> cards(positions.size());
+		/**
+		 * Writes the cardinalities of the given positions to cards without allocating.
+		 * @param positions positions to get the cardinalities for
+		 * @param cards output; must hold at least positions.size() elements
+		 */
+		void getCards(std::span<pos_type const> positions, std::span<size_t> cards) const noexcept {
+			assert(cards.size() >= positions.size());
 			for (size_t i = 0; i < positions.size(); ++i) {
 				auto pos = positions[i];
 				assert(pos < depth);
 				cards[i] = edges(pos).size();
 			}
+		}
+
+		[[nodiscard]] std::vector<size_t> getCards(std::vector<pos_type> const &positions) const noexcept {
+			std::vector<size_t> cards(positions.size());
+			getCards(positions, cards);
 			return cards;
 		}
 
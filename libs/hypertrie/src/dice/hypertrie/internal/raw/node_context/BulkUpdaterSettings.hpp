@@ -1,18 +1,35 @@
 #ifndef HYPERTRIE_BULKUPDATER_SETTINGS_HPP
 #define HYPERTRIE_BULKUPDATER_SETTINGS_HPP
 
+#include "dice/hypertrie/Hypertrie_trait.hpp"
+#include "dice/hypertrie/internal/util/Backoff.hpp"
+
 namespace dice::hypertrie::internal::raw {
 
 	enum struct BulkUpdaterMode {
-		Insert,
-		Remove
+		Insert,///< inserts entries (Boolean valued hypertries only)
+		Remove,///< removes entries (Boolean valued hypertries only)
+		Set,   ///< sets the values of keys, a value of zero removes the key (non-Boolean valued hypertries only)
+		Add    ///< adds the values to the values of keys, keys that reach zero are removed (non-Boolean valued hypertries only)
 	};
 
+	/**
+	 * Insert and Remove are supported for Boolean valued hypertries. Set and Add are supported for non-Boolean valued hypertries.
+	 */
+	template<BulkUpdaterMode mode, typename htt_t>
+	concept BulkUpdaterModeSupported = HypertrieTrait<htt_t> and
+									   ((mode == BulkUpdaterMode::Insert or mode == BulkUpdaterMode::Remove) == HypertrieTrait_bool_valued<htt_t>);
+
 	enum struct BulkUpdaterSyncness {
 		Sync,
 		Async,
 	};
 
+	/**
+	 * How the threads of an asynchronous bulk updater wait for each other. By default, they spin briefly and then park.
+	 */
+	using BulkUpdaterBackoff = util::BackoffSettings;
+
 } // namespace dice::hypertrie::internal::raw
 
 #endif//HYPERTRIE_BULKUPDATER_SETTINGS_HPP
@@ -5,34 +5,104 @@
 #include "dice/hypertrie/internal/raw/node_context/BulkUpdaterSettings.hpp"
 #include "dice/hypertrie/internal/raw/node_context/BulkUpdater_callback.hpp"
 #include "dice/hypertrie/internal/raw/node_context/RawHypertrieContext.hpp"
+#include "dice/hypertrie/internal/raw/node_context/SnapshotRegistry.hpp"
+#include "dice/hypertrie/internal/util/Backoff.hpp"
 #include "dice/hypertrie/internal/util/folly_ProducerConsumerQueue.hpp"
 
 #include <robin_hood.h>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <functional>
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace dice::hypertrie::internal::raw {
 
 
-	template<BulkUpdaterMode mode, size_t depth, HypertrieTrait_bool_valued htt_t, ByteAllocator allocator_type, size_t context_max_depth>
+	/**
+	 * Collects entries from one or more producer threads and applies them in bulks to a hypertrie on a separate thread.
+	 * Each producer has an own single-producer/single-consumer queue. The queues are merged by the consumer thread.
+	 * A producer is identified by an index in [0, producers). At any time, each producer index must be used by at most one thread.
+	 * Producers that wait for queue space, the consumer that waits for entries and flush() back off as configured by BulkUpdaterBackoff.
+	 *
+	 * Bulks are processed in a pipeline of two stages that run on separate threads. While stage 2 applies a bulk, stage 1 collects
+	 * the next bulk from the queues. Stage 1 deduplicates the entries of a bulk. Entries that do not change the hypertrie
+	 * (inserted entries that are contained already, removed entries that are not contained) are filtered out by stage 1 if the
+	 * committed root can be read while stage 2 writes, i.e. if the node storage is sharded and the hypertrie is published in snapshots.
+	 * Then, the entries of the bulk in stage 2 are considered applied already. Otherwise, stage 2 filters a bulk right before it is applied.
+	 *
+	 * In the modes Set and Add, stage 1 neither deduplicates nor filters entries. Entries with the same key are combined when stage 2
+	 * applies the bulk (see RawHypertrieContext::set_values and RawHypertrieContext::add_to_values).
+	 */
+	template<BulkUpdaterMode mode, size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t context_max_depth>
+		requires BulkUpdaterModeSupported<mode, htt_t>
 	class RawHypertrieBulkUpdater {
-		// TODO: extend to non-Boolean valued hypertries
-		// TODO: extend to change values (only non-Boolean valued hypertries)
+		static constexpr bool updates_values = mode == BulkUpdaterMode::Set or mode == BulkUpdaterMode::Add;
+
 	public:
 		using Entry = SingleEntry<depth, htt_t>;
 		using key_part_type = typename htt_t::key_part_type;
 
 	private:
-		folly_standalone::ProducerConsumerQueue<Entry> entry_queue_;
+		using EntryQueue = folly_standalone::ProducerConsumerQueue<Entry>;
+		using IdentifierSet = ::robin_hood::unordered_set<RawIdentifier<depth, htt_t>>;
+
+		/**
+		 * Number of NonZeroEntries that are converted at once by add_batch.
+		 */
+		static constexpr size_t conversion_chunk_size = 64;
+
+		/**
+		 * Number of entries that the consumer reads before it wakes up producers that wait for queue space.
+		 */
+		static constexpr size_t read_notification_interval = 64;
+
+		/**
+		 * A bulk that is handed over from stage 1 to stage 2.
+		 */
+		struct Bulk {
+			std::vector<Entry> entries;
+			std::vector<size_t> entry_hashes;///< RawIdentifier::entry_hash of each of entries. Only used by the modes that deduplicate entries.
+			size_t seen_entries = 0;
+			/**
+			 * True if entries that do not change the hypertrie were filtered out by stage 1 already.
+			 */
+			bool filtered = false;
+		};
+
+		std::vector<std::unique_ptr<EntryQueue>> entry_queues_;
+		size_t next_queue_ = 0;// only used by the consumer thread
 		uint32_t const bulk_size_; // this is must be exacty here for memory alignment
 		RawNodeContainer<htt_t, allocator_type> *nodec_;
 		RawHypertrieContext<context_max_depth, htt_t, allocator_type> *context_;
 		std::unique_ptr<std::jthread> check_and_insertion_thread_;
+		std::unique_ptr<std::jthread> apply_thread_;
 		std::vector<Entry> new_entries_;// buffer_size
+		std::vector<size_t> new_entry_hashes_;///< see Bulk::entry_hashes
 		BulkUpdater_bulk_processed_callback get_stats_;
+		size_t workers_;
+		SnapshotRegistry<context_max_depth, htt_t, allocator_type> *snapshots_;
 		std::atomic<bool> please_flush_ = false;
+		BulkUpdaterBackoff backoff_;
+		util::WaitSignal entries_queued_;
+		util::WaitSignal entries_read_;
+		util::WaitSignal flushed_;
+		/**
+		 * The bulk in stage 2. It is owned by stage 1 while bulk_pending_ is false and by stage 2 otherwise.
+		 */
+		Bulk applied_bulk_;
+		std::atomic<bool> bulk_pending_ = false;
+		util::WaitSignal bulk_pending_changed_;
+		/**
+		 * Identifiers of (at least) the entries of the bulk in stage 2. Only used by stage 1.
+		 */
+		IdentifierSet in_flight_;
 
 	public:
 		/**
@@ -40,110 +110,323 @@ namespace dice::hypertrie::internal::raw {
 		 * @param context
 		 * @param bulk_size
 		 * @param get_stats see BulkUpdater_bulk_processed_callback
+		 * @param workers maximum number of threads used to apply a bulk to the hypertrie
+		 * @param snapshots if not nullptr, bulks are committed via the registry so that they become visible to snapshot readers as a whole
+		 * @param producers number of threads that may add entries concurrently
+		 * @param backoff how producers, the consumer and flush() wait
 		 */
 		RawHypertrieBulkUpdater(
 				RawNodeContainer<htt_t, allocator_type> &nodec,
 				RawHypertrieContext<context_max_depth, htt_t, allocator_type> &context,
 				uint32_t bulk_size = 1'000'000U,
-				BulkUpdater_bulk_processed_callback get_stats = [](auto...) {}) noexcept
-			: entry_queue_{(bulk_size > 2) ? bulk_size : uint32_t(2)},
-			  bulk_size_((bulk_size > 2) ? bulk_size : uint32_t(2)),
+				BulkUpdater_bulk_processed_callback get_stats = [](auto...) {},
+				size_t workers = 1,
+				SnapshotRegistry<context_max_depth, htt_t, allocator_type> *snapshots = nullptr,
+				size_t producers = 1,
+				BulkUpdaterBackoff backoff = {}) noexcept
+			: bulk_size_((bulk_size > 2) ? bulk_size : uint32_t(2)),
 			  nodec_(&nodec),
-			  context_(&context), get_stats_(std::move(get_stats)) {
+			  context_(&context), get_stats_(std::move(get_stats)), workers_(workers), snapshots_(snapshots), backoff_(backoff) {
 
-			new_entries_.reserve(bulk_size_ + 1);
-			check_and_insertion_thread_ =
-					std::make_unique<std::jthread>([&](std::stop_token const &stoken) {
-						size_t const deduplication_max_size = 4UL * bulk_size_;
-						bool done = false;
-						Entry entry;
-						while (not done) {
-							::robin_hood::unordered_set<RawIdentifier<depth, htt_t>> de_duplication(bulk_size_ + 1);
-							size_t no_seen_entries = 0;
-
-							while (new_entries_.size() < bulk_size_ and not please_flush_.load()) {
-								if (entry_queue_.read(entry)) {
-									no_seen_entries++;
-									RawIdentifier<depth, htt_t> id{entry};
-									const auto &[_, is_new] = de_duplication.insert(id);
-
-									if (de_duplication.size() == deduplication_max_size) {
-										de_duplication.clear();
-
-										// reinsert all entries already chosen for the current bulk
-										// to prevent duplicates in current bulk
-										for (auto const &e : new_entries_) {
-											de_duplication.insert(RawIdentifier<depth, htt_t>{e});
-										}
-									}
-
-									if (is_new) {
-										bool const contained = context_->template get<depth>(NodeContainer<depth, htt_t, allocator_type>{*nodec_}, entry.key());
-
-										if constexpr (mode == BulkUpdaterMode::Insert) {
-											if (not contained) {
-												new_entries_.push_back(entry);
-											}
-										} else if constexpr (mode == BulkUpdaterMode::Remove) {
-											if (contained) {
-												new_entries_.push_back(entry);
-											}
-										}
-									}
-								} else if (stoken.stop_requested()) {
-									done = true;
-									break;
-								}
-							}
-							NodeContainer<depth, htt_t, allocator_type> nodec{*nodec_};
+			// the queues together hold about one bulk
+			auto const queue_size = std::max(uint32_t(2), static_cast<uint32_t>(bulk_size_ / std::max(producers, size_t(1))));
+			entry_queues_.reserve(std::max(producers, size_t(1)));
+			do {
+				entry_queues_.push_back(std::make_unique<EntryQueue>(queue_size));
+			} while (entry_queues_.size() < producers);
 
-							auto const new_entries_size = new_entries_.size();
-							if constexpr (mode == BulkUpdaterMode::Insert) {
-								context_->insert(nodec, std::move(new_entries_));
-							} else if constexpr (mode == BulkUpdaterMode::Remove) {
-								context_->remove(nodec, std::move(new_entries_));
-							}
-
-							*nodec_ = nodec;
-							get_stats_(no_seen_entries, new_entries_size, context_->size(nodec));
-							new_entries_.clear();
-							please_flush_.store(false);
-						}
-					});
+			new_entries_.reserve(bulk_size_ + 1);
+			if constexpr (not updates_values)
+				new_entry_hashes_.reserve(bulk_size_ + 1);
+			apply_thread_ = std::make_unique<std::jthread>([this](std::stop_token const &stoken) { apply_bulks(stoken); });
+			check_and_insertion_thread_ = std::make_unique<std::jthread>([this](std::stop_token const &stoken) { collect_bulks(stoken); });
 		}
 
 		~RawHypertrieBulkUpdater() noexcept {
 			check_and_insertion_thread_->request_stop();
+			entries_queued_.notify();
 			if (check_and_insertion_thread_->joinable()) [[likely]]
 				check_and_insertion_thread_->join();
+			// stage 1 handed over its last bulk and waited for it to be applied
+			apply_thread_->request_stop();
+			bulk_pending_changed_.notify();
+			if (apply_thread_->joinable()) [[likely]]
+				apply_thread_->join();
 		}
 
-		void add(Entry const &entry) noexcept {
+		/**
+		 * @param entry entry to be added
+		 * @param producer index of the calling producer
+		 */
+		void add(Entry const &entry, size_t producer = 0) noexcept {
+			assert(producer < entry_queues_.size());
+			auto &queue = *entry_queues_[producer];
 			while (true) {
-				bool push_succeeded = entry_queue_.write(entry);
-				if (push_succeeded) [[likely]]
+				bool push_succeeded = queue.write(entry);
+				if (push_succeeded) [[likely]] {
+					entries_queued_.notify();
 					return;
+				}
+				entries_read_.wait_until([&]() { return not queue.isFull(); }, backoff_);
+			}
+		}
+
+		void add(NonZeroEntry<htt_t> const &entry, size_t producer = 0) {
+			add(to_raw_entry(entry), producer);
+		}
+
+		/**
+		 * Adds multiple entries. The entries are written to the queue of producer in as few steps as possible.
+		 * @param entries entries to be added
+		 * @param producer index of the calling producer
+		 */
+		void add_batch(std::span<Entry const> entries, size_t producer = 0) noexcept {
+			assert(producer < entry_queues_.size());
+			auto &queue = *entry_queues_[producer];
+			while (not entries.empty()) {
+				if (auto const written = queue.writeBatch(entries.data(), entries.size()); written != 0) {
+					entries = entries.subspan(written);
+					entries_queued_.notify();
+				} else {
+					entries_read_.wait_until([&]() { return not queue.isFull(); }, backoff_);
+				}
 			}
 		}
 
-		void add(NonZeroEntry<htt_t> const &entry) {
-			if (entry.size() == depth) [[likely]] {
-				Entry raw_entry;
-				std::copy(entry.key().begin(), entry.key().end(),
-						  raw_entry.key().begin());
-				add(raw_entry);
-			} else [[unlikely]] {
-				throw std::logic_error{
-						"The provided NonZeroEntry has a wrong depth/size."};
+		void add_batch(std::span<NonZeroEntry<htt_t> const> entries, size_t producer = 0) {
+			std::array<Entry, conversion_chunk_size> raw_entries;
+			while (not entries.empty()) {
+				auto const chunk_size = std::min(entries.size(), conversion_chunk_size);
+				for (size_t i = 0; i < chunk_size; ++i)
+					raw_entries[i] = to_raw_entry(entries[i]);
+				add_batch(std::span<Entry const>{raw_entries.data(), chunk_size}, producer);
+				entries = entries.subspan(chunk_size);
 			}
 		}
 
+		/**
+		 * @return number of threads that may add entries concurrently
+		 */
+		[[nodiscard]] size_t producers() const noexcept { return entry_queues_.size(); }
+
 		[[nodiscard]] size_t size() const noexcept { return new_entries_.size(); }
 
+		/**
+		 * Returns once all entries that were added before are applied. With concurrent producers, it waits until all queues were drained once.
+		 */
 		void flush() {
 			please_flush_.store(true);
-			while (please_flush_.load())
-				;
+			entries_queued_.notify();
+			flushed_.wait_until([&]() { return not please_flush_.load(); }, backoff_);
+		}
+
+	private:
+		static Entry to_raw_entry(NonZeroEntry<htt_t> const &entry) {
+			if (entry.size() != depth) [[unlikely]]
+				throw std::logic_error{"The provided NonZeroEntry has a wrong depth/size."};
+			Entry raw_entry;
+			std::copy(entry.key().begin(), entry.key().end(),
+					  raw_entry.key().begin());
+			if constexpr (not htt_t::is_bool_valued)
+				raw_entry.value() = entry.value();
+			return raw_entry;
+		}
+
+		/**
+		 * @param contained if the entry is contained in the hypertrie before the bulk is applied
+		 * @return if an entry changes the hypertrie
+		 */
+		static bool changes_hypertrie(bool contained) noexcept {
+			if constexpr (mode == BulkUpdaterMode::Insert)
+				return not contained;
+			else
+				return contained;
+		}
+
+		static RawIdentifier<depth, htt_t> identify(Entry const &entry, size_t const &entry_hash) noexcept {
+			return RawIdentifier<depth, htt_t>{std::span<Entry const>{&entry, 1}, std::span<size_t const>{&entry_hash, 1}};
+		}
+
+		/**
+		 * Stage 1: collects bulks from the queues and hands them over to stage 2.
+		 */
+		void collect_bulks(std::stop_token const &stoken) {
+			size_t const deduplication_max_size = 4UL * bulk_size_;
+			bool done = false;
+			Entry entry;
+			size_t reads_since_notification = 0;
+			IdentifierSet de_duplication(bulk_size_ + 1);
+			while (not done) {
+				de_duplication.clear();
+				size_t no_seen_entries = 0;
+
+				// the committed root can only be read while stage 2 writes if its nodes are not changed in place
+				typename SnapshotRegistry<context_max_depth, htt_t, allocator_type>::PinnedRoot pinned_root{};
+				if constexpr (htt_t::node_storage_shards > 1 and not updates_values) {
+					if (snapshots_ != nullptr)
+						pinned_root = snapshots_->snapshot(*nodec_);
+				}
+				bool const filter = pinned_root.root != nullptr;
+
+				// a flush completes once all entries that were queued before it are applied
+				bool flush_drained = false;
+				while (new_entries_.size() < bulk_size_) {
+					if (read(entry)) {
+						no_seen_entries++;
+						if (++reads_since_notification == read_notification_interval) {
+							reads_since_notification = 0;
+							entries_read_.notify();
+						}
+						if constexpr (updates_values) {
+							new_entries_.push_back(entry);
+							continue;
+						}
+						if (de_duplication.size() == deduplication_max_size) {
+							de_duplication.clear();
+
+							// reinsert all entries already chosen for the current bulk
+							// to prevent duplicates in current bulk
+							for (size_t i = 0; i < new_entries_.size(); ++i) {
+								de_duplication.insert(identify(new_entries_[i], new_entry_hashes_[i]));
+							}
+						}
+
+						// the hash is kept with the entry, so that it is not hashed again when the bulk is applied
+						auto const entry_hash = RawIdentifier<depth, htt_t>::entry_hash(entry);
+						auto const id = identify(entry, entry_hash);
+						const auto &[_, is_new] = de_duplication.insert(id);
+
+						if (not is_new)
+							continue;
+						if (filter) {
+							// entries of the bulk in stage 2 are considered applied: it is committed before this bulk
+							if (in_flight_.contains(id))
+								continue;
+							bool const contained = context_->template get<depth>(NodeContainer<depth, htt_t, allocator_type>{pinned_root.root->nodec}, entry.key());
+							if (not changes_hypertrie(contained))
+								continue;
+						}
+						new_entries_.push_back(entry);
+						new_entry_hashes_.push_back(entry_hash);
+					} else if (stoken.stop_requested() and queues_empty()) {
+						// entries may have been written between the failed read and the stop request
+						done = true;
+						break;
+					} else if (please_flush_.load() and queues_empty()) {
+						// entries may have been written between the failed read and the flush request
+						flush_drained = true;
+						break;
+					} else {
+						entries_read_.notify();
+						entries_queued_.wait_until([&]() { return not queues_empty() or please_flush_.load() or stoken.stop_requested(); }, backoff_);
+					}
+				}
+				// producers may add entries while the bulk is applied
+				entries_read_.notify();
+				pinned_root = {};
+
+				// hand the bulk over to stage 2 once it is done with the previous one
+				wait_for_stage_2();
+				applied_bulk_.entries.swap(new_entries_);
+				applied_bulk_.entry_hashes.swap(new_entry_hashes_);
+				applied_bulk_.seen_entries = no_seen_entries;
+				applied_bulk_.filtered = filter;
+				// if the bulk is not filtered by stage 1, stage 2 filters it. Its entries are applied either way.
+				in_flight_.swap(de_duplication);
+				bulk_pending_.store(true);
+				bulk_pending_changed_.notify();
+
+				if (flush_drained or done) {
+					wait_for_stage_2();
+					please_flush_.store(false);
+					flushed_.notify();
+				}
+			}
+		}
+
+		void wait_for_stage_2() {
+			bulk_pending_changed_.wait_until([&]() { return not bulk_pending_.load(); }, backoff_);
+		}
+
+		/**
+		 * Stage 2: applies the bulks that are handed over by stage 1.
+		 */
+		void apply_bulks(std::stop_token const &stoken) {
+			while (true) {
+				bulk_pending_changed_.wait_until([&]() { return bulk_pending_.load() or stoken.stop_requested(); }, backoff_);
+				if (not bulk_pending_.load())
+					return;
+
+				auto &entries = applied_bulk_.entries;
+				auto &entry_hashes = applied_bulk_.entry_hashes;
+				if (not updates_values and not applied_bulk_.filtered and not entries.empty()) {
+					// the keys of the bulk are looked up all at once
+					std::vector<RawKey<depth, htt_t>> keys;
+					keys.reserve(entries.size());
+					for (auto const &entry : entries)
+						keys.push_back(entry.key());
+					std::vector<bool> changes(entries.size());
+					context_->template get_many<depth>(NodeContainer<depth, htt_t, allocator_type>{*nodec_}, std::span<RawKey<depth, htt_t> const>{keys},
+													   [&](size_t i, bool contained) { changes[i] = changes_hypertrie(contained); });
+					// entries and their hashes are compacted alike
+					size_t kept = 0;
+					for (size_t i = 0; i < entries.size(); ++i) {
+						if (not changes[i])
+							continue;
+						entries[kept] = entries[i];
+						entry_hashes[kept] = entry_hashes[i];
+						++kept;
+					}
+					entries.resize(kept);
+					entry_hashes.resize(kept);
+				}
+				auto const new_entries_size = entries.size();
+				if (not entries.empty()) {
+					auto apply = [&](NodeContainer<depth, htt_t, allocator_type> &nodec) {
+						if constexpr (mode == BulkUpdaterMode::Insert) {
+							context_->insert(nodec, std::move(entries), entry_hashes, workers_);
+						} else if constexpr (mode == BulkUpdaterMode::Remove) {
+							context_->remove(nodec, std::move(entries), entry_hashes, workers_);
+						} else if constexpr (mode == BulkUpdaterMode::Set) {
+							context_->set_values(nodec, std::move(entries), workers_);
+						} else if constexpr (mode == BulkUpdaterMode::Add) {
+							context_->add_to_values(nodec, std::move(entries), workers_);
+						}
+					};
+					if (snapshots_ != nullptr) {
+						snapshots_->template commit<depth>(*nodec_, apply);
+					} else {
+						NodeContainer<depth, htt_t, allocator_type> nodec{*nodec_};
+						apply(nodec);
+						*nodec_ = nodec;
+					}
+				}
+
+				get_stats_(applied_bulk_.seen_entries, new_entries_size, context_->size(NodeContainer<depth, htt_t, allocator_type>{*nodec_}));
+				entries.clear();
+				entry_hashes.clear();
+				bulk_pending_.store(false);
+				bulk_pending_changed_.notify();
+			}
+		}
+
+		[[nodiscard]] bool queues_empty() const noexcept {
+			return std::ranges::all_of(entry_queues_, [](auto const &queue) { return queue->isEmpty(); });
+		}
+
+		/**
+		 * Reads the next entry from the producer queues. The queues are visited round-robin so that no producer is starved.
+		 * @return false if all queues are empty
+		 */
+		bool read(Entry &entry) noexcept {
+			for (size_t visited = 0; visited < entry_queues_.size(); ++visited) {
+				auto &queue = *entry_queues_[next_queue_];
+				if (++next_queue_ == entry_queues_.size())
+					next_queue_ = 0;
+				if (queue.read(entry))
+					return true;
+			}
+			return false;
 		}
 	};
 
@@ -14,9 +14,15 @@
 #include "dice/hypertrie/internal/raw/node/SingleEntryNode.hpp"
 #include "dice/hypertrie/internal/raw/node_context/SliceResult.hpp"
 #include "dice/hypertrie/internal/raw/node_context/update_details/ApplyUpdate.hpp"
+#include "dice/hypertrie/internal/raw/node_context/update_details/BulkLoad.hpp"
+#include "dice/hypertrie/internal/util/Prefetch.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -103,52 +109,187 @@ namespace dice::hypertrie::internal::raw {
 			}
 
 			if (value == value_type{}) {
-				if constexpr (htt_t::is_bool_valued) {
-					remove(nodec, {SingleEntry<depth, htt_t>{key, true}});
-				} else {
-					// TODO FIX: for non-bool hypertries the value fed to remove needs to match the existing value exactly, which is annoying to use
-					// TODO FIX: implement removal correctly for non-bool hypertries
-					assert(false);
-				}
-
+				// the removed entry must match the stored value exactly
+				remove(nodec, {SingleEntry<depth, htt_t>{key, old_value}});
 				return old_value;
 			}
 
 			if (old_value == value_type{}) {
 				insert(nodec, {SingleEntry<depth, htt_t>{key, value}});
+			} else if constexpr (not htt_t::is_bool_valued) {
+				node_context::update_details::change_values_in_node(node_storage_, nodec, {SingleEntry<depth, htt_t>{key, old_value}}, {SingleEntry<depth, htt_t>{key, value}});
 			}
-			/*
-			else {
-				change_values(nodec, {entry});
-			}
-			*/
 
 			return old_value;
 		}
 
+		/**
+		 * Changes the values of entries. The keys of all entries must be contained in nodec with a different value.
+		 * @tparam depth depth of the hypertrie
+		 * @param nodec nodec
+		 * @param entries entries with their new values. The values must not be zero.
+		 * @param workers maximum number of threads used to apply the update
+		 */
 		template<size_t depth>
-		void change_values([[maybe_unused]] NodeContainer<depth, htt_t, allocator_type> &nodec,
-						   [[maybe_unused]] std::vector<SingleEntry<depth, htt_t>> const &entries) noexcept {
-			assert(false);
-			// TODO: implement
+		void change_values(NodeContainer<depth, htt_t, allocator_type> &nodec,
+						   std::vector<SingleEntry<depth, htt_t>> &&entries,
+						   size_t workers = 1) noexcept
+			requires(not htt_t::is_bool_valued)
+		{
+			std::vector<SingleEntry<depth, htt_t>> old_entries;
+			old_entries.reserve(entries.size());
+			for (auto const &entry : entries)
+				old_entries.emplace_back(entry.key(), get(nodec, entry.key()));
+			node_context::update_details::change_values_in_node(node_storage_, nodec, std::move(old_entries), std::move(entries), workers);
 		}
 
+		/**
+		 * Sets the values of keys. Keys with a new value of zero are removed, new keys are inserted and the values of other keys are changed.
+		 * If a key occurs multiple times, the last value wins.
+		 * @tparam depth depth of the hypertrie
+		 * @param nodec nodec
+		 * @param entries keys with their new values
+		 * @param workers maximum number of threads used to apply the update
+		 */
+		template<size_t depth>
+		void set_values(NodeContainer<depth, htt_t, allocator_type> &nodec,
+						std::vector<SingleEntry<depth, htt_t>> &&entries,
+						size_t workers = 1) noexcept
+			requires(not htt_t::is_bool_valued)
+		{
+			update_values(nodec, std::move(entries), workers, []([[maybe_unused]] value_type current, value_type value) { return value; });
+		}
+
+		/**
+		 * Adds deltas to the values of keys. Keys that are not contained have the value zero. Keys whose value becomes zero are removed.
+		 * If a key occurs multiple times, all its deltas are added.
+		 * @tparam depth depth of the hypertrie
+		 * @param nodec nodec
+		 * @param deltas keys with the deltas to be added to their values
+		 * @param workers maximum number of threads used to apply the update
+		 */
+		template<size_t depth>
+		void add_to_values(NodeContainer<depth, htt_t, allocator_type> &nodec,
+						   std::vector<SingleEntry<depth, htt_t>> &&deltas,
+						   size_t workers = 1) noexcept
+			requires(not htt_t::is_bool_valued)
+		{
+			update_values(nodec, std::move(deltas), workers, [](value_type current, value_type delta) { return current + delta; });
+		}
+
+	private:
+		/**
+		 * Splits updates into removals, value changes and insertions and applies them in that order.
+		 * @param update_value computes the new value of a key from its current value and an update
+		 */
+		template<size_t depth, typename UpdateValue>
+		void update_values(NodeContainer<depth, htt_t, allocator_type> &nodec,
+						   std::vector<SingleEntry<depth, htt_t>> &&updates,
+						   size_t workers,
+						   UpdateValue &&update_value) noexcept {
+			using SingleEntry_t = SingleEntry<depth, htt_t>;
+			// updates of the same key become adjacent and keep their order
+			std::ranges::stable_sort(updates, [](SingleEntry_t const &lhs, SingleEntry_t const &rhs) { return lhs.key() < rhs.key(); });
+
+			std::vector<SingleEntry_t> removals;
+			std::vector<SingleEntry_t> old_entries;
+			std::vector<SingleEntry_t> changed_entries;
+			std::vector<SingleEntry_t> insertions;
+			for (auto iter = updates.begin(); iter != updates.end();) {
+				auto const key = iter->key();
+				value_type const old_value = get(nodec, key);
+				value_type new_value = old_value;
+				for (; iter != updates.end() and iter->key() == key; ++iter)
+					new_value = update_value(new_value, iter->value());
+
+				if (new_value == old_value)
+					continue;
+				if (old_value == value_type{}) {
+					insertions.emplace_back(key, new_value);
+				} else if (new_value == value_type{}) {
+					removals.emplace_back(key, old_value);
+				} else {
+					old_entries.emplace_back(key, old_value);
+					changed_entries.emplace_back(key, new_value);
+				}
+			}
+
+			remove(nodec, std::move(removals), workers);
+			node_context::update_details::change_values_in_node(node_storage_, nodec, std::move(old_entries), std::move(changed_entries), workers);
+			insert(nodec, std::move(insertions), workers);
+		}
+
+	public:
+		/**
+		 * Entries must not yet be contained in nodec
+		 * @tparam depth depth of the hypertrie
+		 * @param nodec nodec
+		 * @param entries
+		 * @param workers maximum number of threads used to apply the update
+		 */
+		template<size_t depth>
+		void insert(NodeContainer<depth, htt_t, allocator_type> &nodec,
+					std::vector<SingleEntry<depth, htt_t>> &&entries,
+					size_t workers = 1) noexcept {
+			node_context::update_details::insert_entries_into_node(node_storage_, nodec, std::move(entries), {}, workers);
+		}
 
 		/**
 		 * Entries must not yet be contained in nodec
 		 * @tparam depth depth of the hypertrie
 		 * @param nodec nodec
 		 * @param entries
+		 * @param entry_hashes RawIdentifier::entry_hash of each entry. Callers that hashed the entries already (e.g., for deduplication) pass them on so they are not hashed again.
+		 * @param workers maximum number of threads used to apply the update
 		 */
 		template<size_t depth>
 		void insert(NodeContainer<depth, htt_t, allocator_type> &nodec,
-					std::vector<SingleEntry<depth, htt_t>> &&entries) noexcept {
-			node_context::update_details::insert_entries_into_node(node_storage_, nodec, std::move(entries));
+					std::vector<SingleEntry<depth, htt_t>> &&entries,
+					std::span<size_t const> entry_hashes,
+					size_t workers = 1) noexcept {
+			node_context::update_details::insert_entries_into_node(node_storage_, nodec, std::move(entries), entry_hashes, workers);
+		}
+
+		/**
+		 * Builds nodec from entries directly instead of inserting them. This is much faster for loading a complete hypertrie.
+		 * @tparam depth depth of the hypertrie
+		 * @param nodec must be empty
+		 * @param entries entries of the hypertrie. Duplicates are removed. They are sorted if they are not sorted already.
+		 */
+		template<size_t depth>
+		void load(NodeContainer<depth, htt_t, allocator_type> &nodec,
+				  std::vector<SingleEntry<depth, htt_t>> &&entries) {
+			node_context::update_details::load_entries_into_empty_node(node_storage_, nodec, std::move(entries));
 		}
 
+		/**
+		 * Entries must be contained in nodec
+		 * @tparam depth depth of the hypertrie
+		 * @param nodec nodec
+		 * @param entries
+		 * @param workers maximum number of threads used to apply the update
+		 */
 		template<size_t depth>
-		void remove(NodeContainer<depth, htt_t, allocator_type> &nodec, std::vector<SingleEntry<depth, htt_t>> &&entries) noexcept {
-			node_context::update_details::erase_entries_from_node(node_storage_, nodec, std::move(entries));
+		void remove(NodeContainer<depth, htt_t, allocator_type> &nodec,
+					std::vector<SingleEntry<depth, htt_t>> &&entries,
+					size_t workers = 1) noexcept {
+			node_context::update_details::erase_entries_from_node(node_storage_, nodec, std::move(entries), {}, workers);
+		}
+
+		/**
+		 * Entries must be contained in nodec
+		 * @tparam depth depth of the hypertrie
+		 * @param nodec nodec
+		 * @param entries
+		 * @param entry_hashes RawIdentifier::entry_hash of each entry. Callers that hashed the entries already (e.g., for deduplication) pass them on so they are not hashed again.
+		 * @param workers maximum number of threads used to apply the update
+		 */
+		template<size_t depth>
+		void remove(NodeContainer<depth, htt_t, allocator_type> &nodec,
+					std::vector<SingleEntry<depth, htt_t>> &&entries,
+					std::span<size_t const> entry_hashes,
+					size_t workers = 1) noexcept {
+			node_context::update_details::erase_entries_from_node(node_storage_, nodec, std::move(entries), entry_hashes, workers);
 		}
 
 		/**
@@ -163,6 +304,21 @@ namespace dice::hypertrie::internal::raw {
 		template<size_t depth>
 		auto resolve(FNContainer<depth, htt_t, allocator_type> const &nodec, pos_type pos, key_part_type key_part) noexcept
 				-> std::conditional_t<(depth > 1), NodeContainer<depth - 1, htt_t, allocator_type>, value_type> {
+			if constexpr (depth > 1 and htt_t::prefetch_lookups) {
+				auto child = resolve_child<depth>(nodec, pos, key_part);
+				// the caller inspects the child right away (min_card_pos reads the edges of all positions)
+				if (child.is_fn())
+					util::prefetch_whole_pointee(child.template specific<FullNode>().node_ptr());
+				return child;
+			} else {
+				return resolve_child<depth>(nodec, pos, key_part);
+			}
+		}
+
+	private:
+		template<size_t depth>
+		auto resolve_child(FNContainer<depth, htt_t, allocator_type> const &nodec, pos_type pos, key_part_type key_part) noexcept
+				-> std::conditional_t<(depth > 1), NodeContainer<depth - 1, htt_t, allocator_type>, value_type> {
 			assert(pos < depth);
 			if (nodec.empty()) {
 				return {};
@@ -183,6 +339,7 @@ namespace dice::hypertrie::internal::raw {
 			}
 		}
 
+	public:
 		template<size_t depth, ByteAllocator allocator_type2>
 		static value_type get(SENContainer<depth, htt_t, allocator_type2> const &nodec, RawKey<depth, htt_t> key) noexcept {
 			auto key_tri = RawKey<depth, htt_t>(key);
@@ -236,18 +393,113 @@ namespace dice::hypertrie::internal::raw {
 			return get(fn_nodec, key);
 		}
 
+		/**
+		 * Retrieves the values for multiple keys. This is faster than calling get for each key if keys share key parts.
+		 * At a full node, the keys are grouped by their key part at the position with the fewest children. The child of a group
+		 * is resolved only once. The children of all groups are resolved (and prefetched) before any of them is descended into,
+		 * so the memory accesses of independent lookups overlap.
+		 * @tparam depth the depth of the node container
+		 * @param nodec the node container
+		 * @param keys the keys
+		 * @param on_value called as on_value(i, value) with the value of keys[i], exactly once for each key. The order is unspecified.
+		 */
+		template<size_t depth, typename OnValue>
+		void get_many(NodeContainer<depth, htt_t, allocator_type> const &nodec, std::span<RawKey<depth, htt_t> const> keys, OnValue &&on_value) {
+			std::vector<uint32_t> key_ids(keys.size());
+			std::iota(key_ids.begin(), key_ids.end(), uint32_t(0));
+			get_many_rek<depth>(nodec, keys, key_ids, on_value);
+		}
+
+	private:
+		/**
+		 * @param key_ids the ids that are passed to on_value for keys, key_ids[i] belongs to keys[i]
+		 */
+		template<size_t depth, typename OnValue>
+		void get_many_rek(NodeContainer<depth, htt_t, allocator_type> const &nodec,
+						  std::span<RawKey<depth, htt_t> const> keys,
+						  std::span<uint32_t const> key_ids,
+						  OnValue &on_value) {
+			assert(keys.size() == key_ids.size());
+			if (keys.size() == 1 or nodec.empty() or nodec.is_sen()) {
+				for (size_t i = 0; i < keys.size(); ++i)
+					on_value(key_ids[i], get(nodec, keys[i]));
+				return;
+			}
+			FNContainer<depth, htt_t, allocator_type> fn_nodec = nodec.template specific<FullNode>();
+			if constexpr (depth == 1) {
+				for (size_t i = 0; i < keys.size(); ++i)
+					on_value(key_ids[i], this->template resolve<1>(fn_nodec, 0UL, keys[i][0]));
+			} else {
+				using Child = NodeContainer<depth - 1, htt_t, allocator_type>;
+				auto const pos = fn_nodec.node_ptr()->min_card_pos();
+
+				// order the keys by the key part at pos, so that keys with equal key parts form a group
+				std::vector<std::pair<key_part_type, uint32_t>> order;
+				order.reserve(keys.size());
+				for (uint32_t i = 0; i < keys.size(); ++i)
+					order.emplace_back(keys[i][pos], i);
+				std::ranges::sort(order);
+
+				// resolve the child of each group before descending into any of them
+				struct Group {
+					uint32_t begin;
+					uint32_t end;
+					Child child;
+				};
+				std::vector<Group> groups;
+				for (uint32_t begin = 0; begin < order.size();) {
+					uint32_t end = begin + 1;
+					while (end < order.size() and order[end].first == order[begin].first)
+						++end;
+					Child child = this->template resolve<depth>(fn_nodec, pos, order[begin].first);
+					if (child.is_fn())
+						util::prefetch_pointee(child.template specific<FullNode>().node_ptr());
+					groups.push_back({begin, end, child});
+					begin = end;
+				}
+
+				std::vector<RawKey<depth - 1, htt_t>> sub_keys;
+				std::vector<uint32_t> sub_key_ids;
+				for (auto const &group : groups) {
+					if (group.child.empty()) {
+						for (auto i = group.begin; i < group.end; ++i)
+							on_value(key_ids[order[i].second], value_type{});
+						continue;
+					}
+					sub_keys.clear();
+					sub_key_ids.clear();
+					for (auto i = group.begin; i < group.end; ++i) {
+						sub_keys.push_back(keys[order[i].second].subkey(pos));
+						sub_key_ids.push_back(key_ids[order[i].second]);
+					}
+					get_many_rek<depth - 1>(group.child, sub_keys, sub_key_ids, on_value);
+				}
+			}
+		}
+
+	public:
+
 
 		template<size_t DEPTH, size_t FIXED_KEYPARTS, ByteAllocator alloc2>
 		using specific_slice_result = std::conditional_t<(DEPTH > FIXED_KEYPARTS), SliceResult<DEPTH - FIXED_KEYPARTS, htt_t, alloc2>, value_type>;
 
+		/**
+		 * Slices a SingleEntryNode. If the result is a SingleEntryNode that is not stored in a context, it is written to sen_result_cache
+		 * and is managed (i.e. must not be deleted). Without sen_result_cache, it is allocated and unmanaged.
+		 */
 		template<size_t depth, size_t fixed_keyparts, ByteAllocator alloc2>
-		static auto slice(SENContainer<depth, htt_t, alloc2> const &nodec, RawSliceKey<fixed_keyparts, htt_t> raw_slice_key) noexcept
+		static auto slice(SENContainer<depth, htt_t, alloc2> const &nodec, RawSliceKey<fixed_keyparts, htt_t> raw_slice_key,
+						  SingleEntryNode<depth - fixed_keyparts, htt_t, std::allocator<std::byte>> *sen_result_cache = nullptr) noexcept
 				-> specific_slice_result<depth, fixed_keyparts, alloc2> {
 			static constexpr size_t result_depth = depth - fixed_keyparts;
 
 			using SliceResult_t = SliceResult<depth - fixed_keyparts, htt_t, alloc2>;
 
 			if constexpr (fixed_keyparts == 0) {
+				if (sen_result_cache != nullptr) {
+					*sen_result_cache = SingleEntryNode<depth, htt_t, std::allocator<std::byte>>{*nodec.node_ptr()};
+					return SliceResult_t::make_sen_with_stl_alloc(true, nodec.raw_identifier(), sen_result_cache);
+				}
 				return SliceResult_t::make_sen_with_stl_alloc(false, nodec.raw_identifier(), new SingleEntryNode<depth, htt_t, std::allocator<std::byte>>{*nodec.node_ptr()});
 			} else if constexpr (depth == fixed_keyparts) {
 				RawKey<depth, htt_t> raw_key;
@@ -267,6 +519,10 @@ namespace dice::hypertrie::internal::raw {
 					if constexpr (result_depth == 1 and HypertrieTrait_bool_valued_and_taggable_key_part<htt_t>)
 						return SliceResult_t::make_with_provided_alloc(identifier);
 					else {
+						if (sen_result_cache != nullptr) {
+							*sen_result_cache = SingleEntryNode<result_depth, htt_t, std::allocator<std::byte>>{entry};
+							return SliceResult_t::make_sen_with_stl_alloc(true, identifier, sen_result_cache);
+						}
 						return SliceResult_t::make_sen_with_stl_alloc(false, identifier, new SingleEntryNode<result_depth, htt_t, std::allocator<std::byte>>(entry));
 					}
 				}
@@ -282,10 +538,12 @@ namespace dice::hypertrie::internal::raw {
 		 * @tparam fixed_keyparts number of fixed key_parts in the slice key
 		 * @param nodec a container with a node.
 		 * @param raw_slice_key the slice key
+		 * @param sen_result_cache if not null, a SingleEntryNode result that is not stored in this context is written here instead of being allocated
 		 * @return see above
 		 */
 		template<size_t depth, size_t fixed_keyparts>
-		auto slice(const NodeContainer<depth, htt_t, allocator_type> &nodec, RawSliceKey<fixed_keyparts, htt_t> raw_slice_key) noexcept
+		auto slice(const NodeContainer<depth, htt_t, allocator_type> &nodec, RawSliceKey<fixed_keyparts, htt_t> raw_slice_key,
+				   SingleEntryNode<depth - fixed_keyparts, htt_t, std::allocator<std::byte>> *sen_result_cache = nullptr) noexcept
 				-> specific_slice_result<depth, fixed_keyparts, allocator_type> {
 			using SliceResult_t = SliceResult<depth - fixed_keyparts, htt_t, allocator_type>;
 			if constexpr (fixed_keyparts == 0) {
@@ -297,12 +555,13 @@ namespace dice::hypertrie::internal::raw {
 				}
 				return get(nodec, raw_key);
 			} else {
-				return nodec.empty() ? SliceResult_t{} : slice_rek(nodec, raw_slice_key);
+				return nodec.empty() ? SliceResult_t{} : slice_rek(nodec, raw_slice_key, sen_result_cache);
 			}
 		}
 
 		template<size_t current_depth, size_t fixed_keyparts>
-		auto slice_rek(const NodeContainer<current_depth, htt_t, allocator_type> &nodec, RawSliceKey<fixed_keyparts, htt_t> const &raw_slice_key) noexcept
+		auto slice_rek(const NodeContainer<current_depth, htt_t, allocator_type> &nodec, RawSliceKey<fixed_keyparts, htt_t> const &raw_slice_key,
+					   SingleEntryNode<current_depth - fixed_keyparts, htt_t, std::allocator<std::byte>> *sen_result_cache = nullptr) noexcept
 				-> specific_slice_result<current_depth, fixed_keyparts, allocator_type> {
 
 			static constexpr size_t result_depth = current_depth - fixed_keyparts;
@@ -310,7 +569,7 @@ namespace dice::hypertrie::internal::raw {
 			using SliceResult_t = SliceResult<result_depth, htt_t, allocator_type>;
 			if (nodec.is_sen()) {
 				SENContainer<current_depth, htt_t, allocator_type> sen_nodec = nodec.template specific<SingleEntryNode>();
-				return slice(sen_nodec, raw_slice_key);
+				return slice(sen_nodec, raw_slice_key, sen_result_cache);
 			}
 			FNContainer<current_depth, htt_t, allocator_type> fn_nodec = nodec.template specific<FullNode>();
 			size_t const slice_key_i = fn_nodec.node_ptr()->min_fixed_keypart_i(raw_slice_key);
@@ -322,7 +581,7 @@ namespace dice::hypertrie::internal::raw {
 			if constexpr (fixed_keyparts == 1) {
 				return SliceResult_t::make_with_provided_alloc(child);
 			} else {
-				return slice_rek<current_depth - 1, fixed_keyparts - 1>(child, raw_slice_key.subkey_i(slice_key_i));
+				return slice_rek<current_depth - 1, fixed_keyparts - 1>(child, raw_slice_key.subkey_i(slice_key_i), sen_result_cache);
 			}
 		}
 
@@ -0,0 +1,215 @@
+#ifndef HYPERTRIE_SLICECACHE_HPP
+#define HYPERTRIE_SLICECACHE_HPP
+
+#include "dice/hypertrie/ByteAllocator.hpp"
+#include "dice/hypertrie/Hypertrie_trait.hpp"
+#include "dice/hypertrie/hypertrie_allocator_trait.hpp"
+#include "dice/hypertrie/internal/commons/PosType.hpp"
+#include "dice/hypertrie/internal/raw/RawKey.hpp"
+#include "dice/hypertrie/internal/raw/node/Identifier.hpp"
+
+#include <dice/hash/DiceHash.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+
+namespace dice::hypertrie::internal::raw {
+
+	/**
+	 * Key of a SliceCache: the identifier of the sliced node, its depth and the fixed positions and key parts of the slice key.
+	 */
+	template<size_t max_depth, HypertrieTrait htt_t>
+	struct SliceCacheKey {
+		using key_part_type = typename htt_t::key_part_type;
+
+		size_t root = Identifier<htt_t>::seed_;
+		uint8_t depth = 0;
+		uint8_t fixed_depth = 0;
+		std::array<pos_type, max_depth> positions{};
+		std::array<key_part_type, max_depth> key_parts{};
+
+		SliceCacheKey() = default;
+
+		template<size_t fixed_keyparts>
+		SliceCacheKey(Identifier<htt_t> root_identifier, size_t root_depth, RawSliceKey<fixed_keyparts, htt_t> const &raw_slice_key) noexcept
+			: root(root_identifier.hash()),
+			  depth(static_cast<uint8_t>(root_depth)),
+			  fixed_depth(static_cast<uint8_t>(fixed_keyparts)) {
+			static_assert(fixed_keyparts <= max_depth);
+			for (size_t i = 0; i < fixed_keyparts; ++i) {
+				positions[i] = raw_slice_key[i].pos;
+				key_parts[i] = raw_slice_key[i].key_part;
+			}
+		}
+
+		bool operator==(SliceCacheKey const &other) const noexcept = default;
+	};
+
+	/**
+	 * Counters of a SliceCache: lookups that were answered from the cache (hits) and that were not (misses),
+	 * and the number of cached slices (size) out of at most capacity.
+	 */
+	struct SliceCacheStats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t size = 0;
+		size_t capacity = 0;
+	};
+
+	/**
+	 * A bounded cache that maps a slice of a node (SliceCacheKey) to the identifier of the resulting node.
+	 * Full entries are replaced following the CLOCK strategy: a hand circles the slots and evicts the first one that was not hit since the hand passed it last.
+	 *
+	 * Identifiers are hashes of the content of a node. So, as long as the sliced node exists, its content and thereby the slice result do not change,
+	 * and the result node exists as well (it is a descendant of the sliced node). Therefore, entries never need to be invalidated.
+	 * Only identifiers are stored, so the cache stays valid in persistent memory.
+	 *
+	 * All methods are thread-safe; they are serialized by a single mutex.
+	 * @tparam max_depth maximum depth of the sliced nodes
+	 * @tparam htt_t hypertrie trait
+	 * @tparam allocator_type allocator used for the slots and the index
+	 */
+	template<size_t max_depth, HypertrieTrait htt_t, ByteAllocator allocator_type>
+	class SliceCache {
+	public:
+		using Key = SliceCacheKey<max_depth, htt_t>;
+
+	private:
+		using ht_allocator_trait = hypertrie_allocator_trait<allocator_type>;
+
+		struct Slot {
+			Key key;
+			size_t result;
+			bool referenced;
+		};
+
+		using slot_alloc_type = typename ht_allocator_trait::template rebind_alloc<Slot>;
+		using slot_pointer = typename ht_allocator_trait::template pointer<Slot>;
+		using Index = typename htt_t::template map_type<Key, size_t, allocator_type>;
+
+		slot_alloc_type slot_alloc_;
+		slot_pointer slots_{};
+		size_t capacity_;
+		size_t size_ = 0;
+		size_t hand_ = 0;
+		Index index_;
+
+		size_t hits_ = 0;
+		size_t misses_ = 0;
+
+		mutable std::mutex mutex_;
+
+	public:
+		/**
+		 * @param capacity maximal number of cached slices. With capacity 0, nothing is cached.
+		 * @param alloc allocator
+		 */
+		SliceCache(size_t capacity, allocator_type const &alloc)
+			: slot_alloc_(alloc), capacity_(capacity), index_(alloc) {
+			if (capacity_ > 0)
+				slots_ = std::allocator_traits<slot_alloc_type>::allocate(slot_alloc_, capacity_);
+		}
+
+		SliceCache(SliceCache const &) = delete;
+		SliceCache(SliceCache &&) = delete;
+		SliceCache &operator=(SliceCache const &) = delete;
+		SliceCache &operator=(SliceCache &&) = delete;
+
+		~SliceCache() {
+			if (capacity_ > 0) {
+				for (size_t i = 0; i < size_; ++i)
+					std::allocator_traits<slot_alloc_type>::destroy(slot_alloc_, std::to_address(slots_ + i));
+				std::allocator_traits<slot_alloc_type>::deallocate(slot_alloc_, slots_, capacity_);
+			}
+		}
+
+		[[nodiscard]] bool enabled() const noexcept {
+			return capacity_ > 0;
+		}
+
+		/**
+		 * Looks up a slice and counts a hit or a miss.
+		 * @param key the slice
+		 * @return the hash of the identifier of the slice result if it is cached (the seed if the slice is empty), otherwise std::nullopt
+		 */
+		[[nodiscard]] std::optional<size_t> find(Key const &key) noexcept {
+			std::lock_guard lock{mutex_};
+			auto found = index_.find(key);
+			if (found == index_.end()) {
+				++misses_;
+				return std::nullopt;
+			}
+			++hits_;
+			Slot &slot = slots_[found->second];
+			slot.referenced = true;
+			return slot.result;
+		}
+
+		/**
+		 * Caches the result of a slice. If the cache is full, an entry is evicted.
+		 * @param key the slice
+		 * @param result the hash of the identifier of the slice result (the seed if the slice is empty)
+		 */
+		void insert(Key const &key, size_t result) {
+			std::lock_guard lock{mutex_};
+			if (capacity_ == 0 or index_.find(key) != index_.end())
+				return;
+			size_t slot_i;
+			if (size_ < capacity_) {
+				slot_i = size_++;
+				std::allocator_traits<slot_alloc_type>::construct(slot_alloc_, std::to_address(slots_ + slot_i), Slot{key, result, false});
+			} else {
+				while (slots_[hand_].referenced) {
+					slots_[hand_].referenced = false;
+					hand_ = (hand_ + 1) % capacity_;
+				}
+				slot_i = hand_;
+				hand_ = (hand_ + 1) % capacity_;
+				index_.erase(slots_[slot_i].key);
+				slots_[slot_i] = Slot{key, result, false};
+			}
+			index_.insert({key, slot_i});
+		}
+
+		/**
+		 * Removes all entries. The counters are kept.
+		 */
+		void clear() noexcept {
+			std::lock_guard lock{mutex_};
+			for (size_t i = 0; i < size_; ++i)
+				std::allocator_traits<slot_alloc_type>::destroy(slot_alloc_, std::to_address(slots_ + i));
+			size_ = 0;
+			hand_ = 0;
+			index_.clear();
+		}
+
+		[[nodiscard]] SliceCacheStats stats() const noexcept {
+			std::lock_guard lock{mutex_};
+			return {hits_, misses_, size_, capacity_};
+		}
+
+		void reset_stats() noexcept {
+			std::lock_guard lock{mutex_};
+			hits_ = 0;
+			misses_ = 0;
+		}
+	};
+
+}// namespace dice::hypertrie::internal::raw
+
+namespace dice::hash {
+	template<typename Policy, size_t max_depth, ::dice::hypertrie::HypertrieTrait htt_t>
+	struct dice_hash_overload<Policy, ::dice::hypertrie::internal::raw::SliceCacheKey<max_depth, htt_t>> {
+		static std::size_t dice_hash(::dice::hypertrie::internal::raw::SliceCacheKey<max_depth, htt_t> const &key) noexcept {
+			// positions and key parts behind fixed_depth are zero in every key
+			return dice_hash_templates<Policy>::dice_hash(std::make_tuple(key.root, key.depth, key.fixed_depth, key.positions, key.key_parts));
+		}
+	};
+}// namespace dice::hash
+
+#endif//HYPERTRIE_SLICECACHE_HPP
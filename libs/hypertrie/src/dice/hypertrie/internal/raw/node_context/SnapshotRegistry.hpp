@@ -0,0 +1,222 @@
+#ifndef HYPERTRIE_SNAPSHOTREGISTRY_HPP
+#define HYPERTRIE_SNAPSHOTREGISTRY_HPP
+
+#include "dice/hypertrie/ByteAllocator.hpp"
+#include "dice/hypertrie/Hypertrie_trait.hpp"
+#include "dice/hypertrie/internal/raw/node/NodeContainer.hpp"
+#include "dice/hypertrie/internal/raw/node_context/RawHypertrieContext.hpp"
+#include "dice/hypertrie/internal/util/EpochManager.hpp"
+#include "dice/template-library/switch_cases.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace dice::hypertrie::internal::raw {
+
+	/**
+	 * Publishes committed roots of hypertries so that reader threads can query a consistent snapshot while a writer updates the hypertrie.
+	 *
+	 * A hypertrie is identified by the address of its RawNodeContainer. Once it is published, the registry holds an additional
+	 * reference to the committed root. So, the writer never modifies nodes that are reachable from the published root in place
+	 * but copies them (copy-on-write). After a commit, the new root is published and the reference to the old root is retired.
+	 * The reference is released (and thereby nodes that are only reachable from the old root are deleted) when no reader is pinned
+	 * to an epoch in which the old root was visible.
+	 *
+	 * Writers must apply all updates of a published hypertrie via commit() and unpublish it before it is destructed.
+	 * Readers must not modify reference counts, i.e., they must not create Hypertries from the snapshot.
+	 * The state of the registry is not persisted by the allocator. All roots must be unpublished before the context is closed.
+	 * @tparam max_depth max depth of the RawHypertrieContext
+	 * @tparam htt_t HypertrieTrait
+	 * @tparam allocator_type allocator of the RawHypertrieContext
+	 */
+	template<size_t max_depth, HypertrieTrait htt_t, ByteAllocator allocator_type>
+	class SnapshotRegistry {
+	public:
+		using RawNodeContainer_t = RawNodeContainer<htt_t, allocator_type>;
+		using RawHypertrieContext_t = RawHypertrieContext<max_depth, htt_t, allocator_type>;
+
+		/**
+		 * A committed root. It is immutable once published.
+		 */
+		struct PublishedRoot {
+			size_t depth;
+			RawNodeContainer_t nodec;
+		};
+
+		/**
+		 * A published root together with the pinned epoch that keeps it alive.
+		 */
+		struct PinnedRoot {
+			util::EpochManager::Pin pin;
+			PublishedRoot const *root = nullptr;
+		};
+
+	private:
+		struct RetiredRoot {
+			util::EpochManager::epoch_type epoch;
+			PublishedRoot const *root;
+		};
+
+		RawHypertrieContext_t *context_;
+		mutable util::EpochManager epochs_;
+		/**
+		 * Serializes publish(), unpublish() and commit().
+		 */
+		std::mutex commit_mutex_;
+		/**
+		 * Guards the structure of published_. Only publish() and unpublish() lock it exclusively.
+		 */
+		mutable std::shared_mutex published_mutex_;
+		std::map<RawNodeContainer_t const *, std::atomic<PublishedRoot const *>> published_;
+		/**
+		 * Guarded by commit_mutex_.
+		 */
+		std::vector<RetiredRoot> retired_;
+
+		template<typename F>
+		static void visit_root(PublishedRoot const &root, F &&f) {
+			if (root.depth == 0 or root.nodec.empty())
+				return;
+			template_library::switch_cases<1, max_depth + 1>(
+					root.depth,
+					[&](auto depth_arg) {
+						NodeContainer<depth_arg, htt_t, allocator_type> nodec{root.nodec};
+						// SENs of depth 1 are stored in-place in the identifier
+						if constexpr (HypertrieTrait_bool_valued_and_taggable_key_part<htt_t> and depth_arg == 1)
+							if (nodec.is_sen())
+								return;
+						f(nodec);
+					},
+					[]() { assert(false); __builtin_unreachable(); });
+		}
+
+		PublishedRoot const *retain(size_t depth, RawNodeContainer_t const &nodec) {
+			auto *root = new PublishedRoot{depth, nodec};
+			visit_root(*root, [&](auto const &node_container) { context_->inc_ref_count(node_container); });
+			return root;
+		}
+
+		void retire(PublishedRoot const *root) {
+			if (root != nullptr)
+				retired_.push_back({epochs_.advance(), root});
+			reclaim();
+		}
+
+		/**
+		 * Releases all retired roots that are not visible to any pinned reader anymore.
+		 */
+		void reclaim() {
+			auto const min_pinned = epochs_.min_pinned();
+			std::erase_if(retired_, [&](RetiredRoot const &retired) {
+				if (retired.epoch >= min_pinned)
+					return false;
+				visit_root(*retired.root, [&](auto const &node_container) { context_->decr_ref_count(node_container); });
+				delete retired.root;
+				return true;
+			});
+		}
+
+	public:
+		explicit SnapshotRegistry(RawHypertrieContext_t &context) noexcept : context_(&context) {}
+
+		SnapshotRegistry(SnapshotRegistry const &) = delete;
+		SnapshotRegistry(SnapshotRegistry &&) = delete;
+		SnapshotRegistry &operator=(SnapshotRegistry const &) = delete;
+		SnapshotRegistry &operator=(SnapshotRegistry &&) = delete;
+
+		/**
+		 * Frees the bookkeeping. References to nodes are not released; the nodes are freed with the context.
+		 */
+		~SnapshotRegistry() noexcept {
+			for (auto const &retired : retired_)
+				delete retired.root;
+			for (auto const &[_, root] : published_)
+				delete root.load();
+		}
+
+		/**
+		 * Publishes the current root of nodec. Does nothing if it is already published.
+		 * @param depth depth of the hypertrie
+		 * @param nodec the root node container of the hypertrie
+		 */
+		void publish(size_t depth, RawNodeContainer_t const &nodec) {
+			std::unique_lock commit_lock{commit_mutex_};
+			std::unique_lock lock{published_mutex_};
+			if (published_.contains(&nodec))
+				return;
+			published_.try_emplace(&nodec, retain(depth, nodec));
+		}
+
+		/**
+		 * Stops publishing nodec. Snapshots that were taken before stay valid.
+		 * @param nodec the root node container of the hypertrie
+		 */
+		void unpublish(RawNodeContainer_t const &nodec) {
+			std::unique_lock commit_lock{commit_mutex_};
+			PublishedRoot const *old_root = nullptr;
+			{
+				std::unique_lock lock{published_mutex_};
+				auto found = published_.find(&nodec);
+				if (found == published_.end())
+					return;
+				old_root = found->second.exchange(nullptr);
+				published_.erase(found);
+			}
+			retire(old_root);
+		}
+
+		[[nodiscard]] bool is_published(RawNodeContainer_t const &nodec) const {
+			std::shared_lock lock{published_mutex_};
+			return published_.contains(&nodec);
+		}
+
+		/**
+		 * Pins the current epoch and returns the last committed root of nodec.
+		 * @param nodec the root node container of the hypertrie
+		 * @return the pinned root; its root is nullptr if nodec is not published
+		 */
+		[[nodiscard]] PinnedRoot snapshot(RawNodeContainer_t const &nodec) const {
+			PinnedRoot pinned_root{epochs_.pin()};
+			std::shared_lock lock{published_mutex_};
+			auto found = published_.find(&nodec);
+			if (found != published_.end())
+				pinned_root.root = found->second.load();
+			return pinned_root;
+		}
+
+		/**
+		 * Applies an update to the hypertrie with the root nodec and publishes the result if nodec is published.
+		 * @tparam depth depth of the hypertrie
+		 * @param nodec the root node container of the hypertrie; it is updated
+		 * @param apply callable that applies the update to a NodeContainer<depth>
+		 */
+		template<size_t depth, typename F>
+		void commit(RawNodeContainer_t &nodec, F &&apply) {
+			std::unique_lock commit_lock{commit_mutex_};
+			NodeContainer<depth, htt_t, allocator_type> updated_nodec{nodec};
+			apply(updated_nodec);
+			nodec = updated_nodec;
+
+			// published_ cannot change while we hold commit_mutex_
+			auto found = published_.find(&nodec);
+			if (found == published_.end())
+				return;
+			retire(found->second.exchange(retain(depth, nodec)));
+		}
+
+		/**
+		 * Releases retired roots that are not visible to any reader anymore. This is done with every commit anyway.
+		 */
+		void collect() {
+			std::unique_lock commit_lock{commit_mutex_};
+			reclaim();
+		}
+	};
+}// namespace dice::hypertrie::internal::raw
+
+#endif//HYPERTRIE_SNAPSHOTREGISTRY_HPP
@@ -6,17 +6,31 @@
 #include "dice/hypertrie/internal/raw/node_context/BulkUpdaterSettings.hpp"
 #include "dice/hypertrie/internal/raw/node_context/BulkUpdater_callback.hpp"
 #include "dice/hypertrie/internal/raw/node_context/RawHypertrieContext.hpp"
+#include "dice/hypertrie/internal/raw/node_context/SnapshotRegistry.hpp"
 
 #include <robin_hood.h>
 
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+#include <span>
+#include <stdexcept>
 #include <utility>
+#include <vector>
 
 namespace dice::hypertrie::internal::raw {
 
-	template<BulkUpdaterMode mode, size_t depth, HypertrieTrait_bool_valued htt_t, ByteAllocator allocator_type, size_t context_max_depth>
+	/**
+	 * Collects entries and applies them in bulks to a hypertrie on the thread that adds the entry completing a bulk.
+	 * With more than one producer, adding entries and flushing are serialized by a mutex.
+	 * In the modes Set and Add, the entries of a bulk are neither deduplicated nor filtered when they are added.
+	 * Entries with the same key are combined when the bulk is applied (see RawHypertrieContext::set_values and RawHypertrieContext::add_to_values).
+	 */
+	template<BulkUpdaterMode mode, size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t context_max_depth>
+		requires BulkUpdaterModeSupported<mode, htt_t>
 	class SynchronousRawHypertrieBulkUpdater {
-		// TODO: extend to non-Boolean valued hypertries
-		// TODO: extend to change values (only non-Boolean valued hypertries)
+		static constexpr bool updates_values = mode == BulkUpdaterMode::Set or mode == BulkUpdaterMode::Add;
+
 	public:
 		using Entry = SingleEntry<depth, htt_t>;
 		using key_part_type = typename htt_t::key_part_type;
@@ -27,9 +41,24 @@ namespace dice::hypertrie::internal::raw {
 		RawNodeContainer<htt_t, allocator_type> *nodec_;
 		RawHypertrieContext<context_max_depth, htt_t, allocator_type> *context_;
 		std::vector<Entry> new_entries_;// buffer_size
+		std::vector<size_t> new_entry_hashes_;///< RawIdentifier::entry_hash of each of new_entries_. Only used by the modes that deduplicate entries.
 		BulkUpdater_bulk_processed_callback get_stats_;
+		size_t workers_;
+		SnapshotRegistry<context_max_depth, htt_t, allocator_type> *snapshots_;
 		::robin_hood::unordered_set<RawIdentifier<depth, htt_t>> de_duplication_;
 		size_t no_seen_entries = 0;
+		size_t producers_;
+		std::mutex mutex_;
+
+		/**
+		 * @return a lock on mutex_ that is only acquired if there is more than one producer
+		 */
+		std::unique_lock<std::mutex> lock() noexcept {
+			std::unique_lock lock{mutex_, std::defer_lock};
+			if (producers_ > 1)
+				lock.lock();
+			return lock;
+		}
 
 	public:
 		/**
@@ -37,75 +66,180 @@ namespace dice::hypertrie::internal::raw {
 		 * @param context
 		 * @param bulk_size
 		 * @param get_stats see BulkUpdater_bulk_processed_callback
+		 * @param workers maximum number of threads used to apply a bulk to the hypertrie
+		 * @param snapshots if not nullptr, bulks are committed via the registry so that they become visible to snapshot readers as a whole
+		 * @param producers number of threads that may add entries concurrently
+		 * @param backoff unused. Entries are applied on the adding thread, so no thread waits for another one.
 		 */
 		SynchronousRawHypertrieBulkUpdater(
 				RawNodeContainer<htt_t, allocator_type> &nodec,
 				RawHypertrieContext<context_max_depth, htt_t, allocator_type> &context,
 				uint32_t bulk_size = 1'000'000U,
-				BulkUpdater_bulk_processed_callback get_stats = [](auto...) {}) noexcept
-			: bulk_size_(bulk_size), deduplication_max_size_(4UL * bulk_size_), nodec_(&nodec), context_(&context), get_stats_(std::move(get_stats)), de_duplication_(bulk_size_ + 1) {
+				BulkUpdater_bulk_processed_callback get_stats = [](auto...) {},
+				size_t workers = 1,
+				SnapshotRegistry<context_max_depth, htt_t, allocator_type> *snapshots = nullptr,
+				size_t producers = 1,
+				[[maybe_unused]] BulkUpdaterBackoff backoff = {}) noexcept
+			: bulk_size_(bulk_size), deduplication_max_size_(4UL * bulk_size_), nodec_(&nodec), context_(&context), get_stats_(std::move(get_stats)), workers_(workers), snapshots_(snapshots), de_duplication_(bulk_size_ + 1), producers_(std::max(producers, size_t(1))) {
 
 			if (bulk_size_ == 0)
 				bulk_size_ = 1;
 			new_entries_.reserve(bulk_size_);
+			if constexpr (not updates_values)
+				new_entry_hashes_.reserve(bulk_size_);
 		}
 
 		~SynchronousRawHypertrieBulkUpdater() {
 			flush();
 		}
 
-		void add(Entry const &entry) noexcept {
-			RawIdentifier<depth, htt_t> entry_hash{entry};
-			const auto &[_, unseen] = de_duplication_.insert(entry_hash);
-			if (de_duplication_.size() == deduplication_max_size_)
-				de_duplication_.clear();
+		/**
+		 * @param entry entry to be added
+		 * @param producer index of the calling producer. Only used for checking.
+		 */
+		void add(Entry const &entry, [[maybe_unused]] size_t producer = 0) noexcept {
+			assert(producer < producers_);
+			auto const guard = lock();
+			add_unlocked(entry);
+		}
 
-			if (not unseen)
-				return;
+		void add(NonZeroEntry<htt_t> const &entry, size_t producer = 0) {
+			add(to_raw_entry(entry), producer);
+		}
 
-			bool const already_stored = context_->template get<depth>(NodeContainer<depth, htt_t, allocator_type>{*nodec_}, entry.key());
+		/**
+		 * Adds multiple entries while holding the lock only once.
+		 * @param entries entries to be added
+		 * @param producer index of the calling producer. Only used for checking.
+		 */
+		void add_batch(std::span<Entry const> entries, [[maybe_unused]] size_t producer = 0) noexcept {
+			assert(producer < producers_);
+			auto const guard = lock();
+			for (auto const &entry : entries)
+				add_unlocked(entry);
+		}
 
-			if constexpr (mode == BulkUpdaterMode::Insert) {
-				if (already_stored) {
-					return;
-				}
-			} else if constexpr (mode == BulkUpdaterMode::Remove) {
-				if (not already_stored) {
-					return;
-				}
+		void add_batch(std::span<NonZeroEntry<htt_t> const> entries, [[maybe_unused]] size_t producer = 0) {
+			assert(producer < producers_);
+			auto const guard = lock();
+			for (auto const &entry : entries)
+				add_unlocked(to_raw_entry(entry));
+		}
+
+		/**
+		 * @return number of threads that may add entries concurrently
+		 */
+		[[nodiscard]] size_t producers() const noexcept { return producers_; }
+
+		[[nodiscard]] size_t size() const noexcept { return new_entries_.size(); }
+
+		void flush() {
+			auto const guard = lock();
+			flush_unlocked();
+		}
+
+	private:
+		static Entry to_raw_entry(NonZeroEntry<htt_t> const &entry) {
+			if (entry.size() != depth) [[unlikely]]
+				throw std::logic_error{"The provided NonZeroEntry has a wrong depth/size."};
+			Entry raw_entry;
+			std::copy(entry.key().begin(), entry.key().end(),
+					  raw_entry.key().begin());
+			if constexpr (not htt_t::is_bool_valued)
+				raw_entry.value() = entry.value();
+			return raw_entry;
+		}
+
+		void add_unlocked(Entry const &entry) noexcept {
+			if constexpr (updates_values) {
+				new_entries_.push_back(entry);
+				if (new_entries_.size() >= bulk_size_)
+					flush_unlocked();
+				return;
+			}
+
+			if (de_duplication_.size() == deduplication_max_size_) {
+				de_duplication_.clear();
+				// reinsert all entries already chosen for the current bulk
+				// to prevent duplicates in current bulk
+				for (size_t i = 0; i < new_entries_.size(); ++i)
+					de_duplication_.insert(identify(new_entries_[i], new_entry_hashes_[i]));
 			}
+			// the hash is kept with the entry, so that it is not hashed again when the bulk is applied
+			auto const entry_hash = RawIdentifier<depth, htt_t>::entry_hash(entry);
+			const auto &[_, unseen] = de_duplication_.insert(identify(entry, entry_hash));
 
+			if (not unseen)
+				return;
+
+			// entries that do not change the hypertrie are removed when the bulk is flushed
 			new_entries_.push_back(entry);
+			new_entry_hashes_.push_back(entry_hash);
 
 			if (new_entries_.size() >= bulk_size_)
-				flush();
+				flush_unlocked();
 		}
 
-
-		void add(NonZeroEntry<htt_t> const &entry) {
-			if (entry.size() == depth) [[likely]] {
-				Entry raw_entry;
-				std::copy(entry.key().begin(), entry.key().end(),
-						  raw_entry.key().begin());
-				add(raw_entry);
-			} else [[unlikely]] {
-				throw std::logic_error{
-						"The provided NonZeroEntry has a wrong depth/size."};
+		/**
+		 * Removes the entries that do not change the hypertrie from the bulk, i.e., inserted entries that are contained already
+		 * and removed entries that are not contained. The keys of the bulk are looked up all at once.
+		 */
+		void remove_unchanging_entries()
+			requires(not updates_values)
+		{
+			std::vector<RawKey<depth, htt_t>> keys;
+			keys.reserve(new_entries_.size());
+			for (auto const &entry : new_entries_)
+				keys.push_back(entry.key());
+			std::vector<bool> changes(new_entries_.size());
+			context_->template get_many<depth>(NodeContainer<depth, htt_t, allocator_type>{*nodec_}, std::span<RawKey<depth, htt_t> const>{keys},
+											   [&](size_t i, bool contained) { changes[i] = (mode == BulkUpdaterMode::Insert) ? not contained : contained; });
+			size_t kept = 0;
+			for (size_t i = 0; i < new_entries_.size(); ++i) {
+				if (not changes[i])
+					continue;
+				new_entries_[kept] = new_entries_[i];
+				new_entry_hashes_[kept] = new_entry_hashes_[i];
+				++kept;
 			}
+			new_entries_.resize(kept);
+			new_entry_hashes_.resize(kept);
 		}
 
-		[[nodiscard]] size_t size() const noexcept { return new_entries_.size(); }
-
-		void flush() {
+		void flush_unlocked() {
+			if constexpr (not updates_values) {
+				if (not new_entries_.empty())
+					remove_unchanging_entries();
+			}
 			if (not new_entries_.empty()) {
-				NodeContainer<depth, htt_t, allocator_type> nodec{*nodec_};
 				auto const new_entries_size = new_entries_.size();
-				context_->insert(nodec, std::move(new_entries_));
-				*nodec_ = nodec;
-				get_stats_(no_seen_entries, new_entries_size, context_->size(nodec));
+				auto apply = [&](NodeContainer<depth, htt_t, allocator_type> &nodec) {
+					if constexpr (mode == BulkUpdaterMode::Insert) {
+						context_->insert(nodec, std::move(new_entries_), new_entry_hashes_, workers_);
+					} else if constexpr (mode == BulkUpdaterMode::Remove) {
+						context_->remove(nodec, std::move(new_entries_), new_entry_hashes_, workers_);
+					} else if constexpr (mode == BulkUpdaterMode::Set) {
+						context_->set_values(nodec, std::move(new_entries_), workers_);
+					} else if constexpr (mode == BulkUpdaterMode::Add) {
+						context_->add_to_values(nodec, std::move(new_entries_), workers_);
+					}
+				};
+				if (snapshots_ != nullptr) {
+					snapshots_->template commit<depth>(*nodec_, apply);
+				} else {
+					NodeContainer<depth, htt_t, allocator_type> nodec{*nodec_};
+					apply(nodec);
+					*nodec_ = nodec;
+				}
+				get_stats_(no_seen_entries, new_entries_size, context_->size(NodeContainer<depth, htt_t, allocator_type>{*nodec_}));
 				new_entries_.clear();
+				new_entry_hashes_.clear();
 			}
 		}
+
+		static RawIdentifier<depth, htt_t> identify(Entry const &entry, size_t const &entry_hash) noexcept {
+			return RawIdentifier<depth, htt_t>{std::span<Entry const>{&entry, 1}, std::span<size_t const>{&entry_hash, 1}};
+		}
 	};
 
 	template<size_t depth, HypertrieTrait_bool_valued htt_t, ByteAllocator allocator_type, size_t context_max_depth>
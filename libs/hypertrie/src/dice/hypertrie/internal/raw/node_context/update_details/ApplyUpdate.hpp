@@ -13,6 +13,7 @@
 #include "dice/hypertrie/internal/raw/node_context/update_details/EntrySubsetForPos.hpp"
 #include "dice/hypertrie/internal/raw/node_context/update_details/UpdatePlan.hpp"
 #include "dice/hypertrie/internal/raw/node_context/update_details/UpdateRequests.hpp"
+#include "dice/hypertrie/internal/util/RunOnWorkers.hpp"
 
 #include <cstdint>
 #include <robin_hood.h>
@@ -20,6 +21,8 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <span>
+#include <variant>
 #include <vector>
 
 namespace dice::hypertrie::internal::raw::node_context::update_details {
@@ -36,11 +39,13 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 	 * @tparam max_depth
 	 * @param node_storage node storage to apply changes to
 	 * @param update_requests updates that are requestd to be executed
+	 * @param workers maximum number of threads used to apply the changes
 	 */
 	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t max_depth>
 	void apply_update(NodeStorage<max_depth, htt_t, allocator_type> &node_storage,
-					  UpdateRequests<depth, htt_t, allocator_type, max_depth> &&update_requests) {
-		ApplyUpdate<depth, htt_t, allocator_type, max_depth>{node_storage, std::move(update_requests)}
+					  UpdateRequests<depth, htt_t, allocator_type, max_depth> &&update_requests,
+					  size_t workers = 1) {
+		ApplyUpdate<depth, htt_t, allocator_type, max_depth>{node_storage, std::move(update_requests), workers}
 				.consume_and_execute();
 	}
 
@@ -54,11 +59,15 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 	 * @param node_storage node storage that holds nodec (if its content is not inlined) and where changes will be applied
 	 * @param nodec this will be updated and reflect the insertion or easure of entries
 	 * @param entries the entries to be inserted or erased into/from nodec
+	 * @param entry_hashes RawIdentifier::entry_hash of each entry, if already computed by the caller (e.g., for deduplication). May be empty.
+	 * @param workers maximum number of threads used to apply the changes
 	 */
 	template<EntriesUpdateMode mode, size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t max_depth>
 	void apply_update(NodeStorage<max_depth, htt_t, allocator_type> &node_storage,
 					  NodeContainer<depth, htt_t, allocator_type> &nodec,
-					  std::vector<SingleEntry<depth, htt_t>> &&entries) {
+					  std::vector<SingleEntry<depth, htt_t>> &&entries,
+					  std::span<size_t const> entry_hashes,
+					  size_t workers = 1) {
 		if (entries.empty()) {
 			return;
 		}
@@ -68,15 +77,15 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		auto const target_id = [&]() {
 			if constexpr (mode == EntriesUpdateMode::INSERT) {
 				if (nodec.empty()) {
-					return update_requests.add_node(std::move(entries));
+					return update_requests.add_node(entries, 1, entry_hashes);
 				}
-				return update_requests.insert_into_node(nodec.raw_identifier(), std::move(entries), true);
+				return update_requests.insert_into_node(nodec.raw_identifier(), entries, true, entry_hashes);
 			} else {// mode == EntriesUpdateMode::ERASE
-				return update_requests.remove_from_node(nodec.raw_identifier(), std::move(entries), true);
+				return update_requests.remove_from_node(nodec.raw_identifier(), entries, true, entry_hashes);
 			}
 		}();
 
-		apply_update(node_storage, std::move(update_requests));
+		apply_update(node_storage, std::move(update_requests), workers);
 
 		if (target_id.empty()) {
 			assert(mode == EntriesUpdateMode::ERASE);
@@ -103,15 +112,47 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t max_depth>
 	void insert_entries_into_node(NodeStorage<max_depth, htt_t, allocator_type> &node_storage,
 								  NodeContainer<depth, htt_t, allocator_type> &nodec,
-								  std::vector<SingleEntry<depth, htt_t>> &&entries) {
-		apply_update<EntriesUpdateMode::INSERT>(node_storage, nodec, std::move(entries));
+								  std::vector<SingleEntry<depth, htt_t>> &&entries,
+								  std::span<size_t const> entry_hashes = {},
+								  size_t workers = 1) {
+		apply_update<EntriesUpdateMode::INSERT>(node_storage, nodec, std::move(entries), entry_hashes, workers);
 	}
 
 	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t max_depth>
 	void erase_entries_from_node(NodeStorage<max_depth, htt_t, allocator_type> &node_storage,
 								 NodeContainer<depth, htt_t, allocator_type> &nodec,
-								 std::vector<SingleEntry<depth, htt_t>> &&entries) {
-		apply_update<EntriesUpdateMode::ERASE>(node_storage, nodec, std::move(entries));
+								 std::vector<SingleEntry<depth, htt_t>> &&entries,
+								 std::span<size_t const> entry_hashes = {},
+								 size_t workers = 1) {
+		apply_update<EntriesUpdateMode::ERASE>(node_storage, nodec, std::move(entries), entry_hashes, workers);
+	}
+
+	/**
+	 * Change the values of entries in the node passed in via nodec.
+	 * @param node_storage node storage that holds nodec and where changes will be applied
+	 * @param nodec this will be updated and reflect the changed values
+	 * @param old_entries entries of nodec with their current values
+	 * @param new_entries the same keys as old_entries in the same order, but with their new values. The values must differ from the old ones and must not be zero.
+	 * @param workers maximum number of threads used to apply the changes
+	 */
+	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t max_depth>
+		requires(!HypertrieTrait_bool_valued<htt_t>)
+	void change_values_in_node(NodeStorage<max_depth, htt_t, allocator_type> &node_storage,
+							   NodeContainer<depth, htt_t, allocator_type> &nodec,
+							   std::vector<SingleEntry<depth, htt_t>> &&old_entries,
+							   std::vector<SingleEntry<depth, htt_t>> &&new_entries,
+							   size_t workers = 1) {
+		if (new_entries.empty()) {
+			return;
+		}
+		assert(not nodec.empty());
+
+		UpdateRequests<depth, htt_t, allocator_type, max_depth> update_requests{node_storage};
+		auto const target_id = update_requests.change_in_node(nodec.raw_identifier(), old_entries, new_entries, true);
+		apply_update(node_storage, std::move(update_requests), workers);
+
+		nodec = node_storage.template lookup<depth>(target_id);
+		assert(!nodec.is_null_ptr());
 	}
 
 	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t max_depth>
@@ -124,6 +165,11 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		using UpdateRequests_t = UpdateRequests<depth, htt_t, allocator_type, max_depth>;
 		using NodeStorage_t = NodeStorage<max_depth, htt_t, allocator_type>;
 
+		/**
+		 * Minimal number of FNs of a level that a worker must have to process. Levels with fewer FN changes per worker are processed with fewer workers.
+		 */
+		static constexpr size_t min_fns_per_worker = 256;
+
 	private:
 		enum struct NodeOrigin : uint8_t {
 			Copied,
@@ -146,11 +192,32 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		template<size_t depth2>
 		using FNCreation = typename UpdatePlan<depth2, htt_t, allocator_type, max_depth>::FNCreation;
 		using FNPtr = typename FNContainer<depth, htt_t, allocator_type>::NodePtr;
+		using EntrySubsets = std::conditional_t<(depth > 1), EntrySubsetsForPos<depth, htt_t>, std::monostate>;
+
+		/**
+		 * Entries to be written into a FN that is already registered (under its target id) in node storage.
+		 */
+		struct FNEntriesJob {
+			FNEntriesUpdate<depth> update;
+			FNPtr fn_ptr;
+			NodeOrigin origin;
+			ssize_t ref_count;///< ref_count to be set after the entries were written. Not used for NodeOrigin::JustCreated.
+		};
+
+		/**
+		 * The work of a single worker. FNs are assigned to workers by the hash of their (target) identifier.
+		 */
+		struct WorkerPartition {
+			std::vector<FNEntriesJob> entries_jobs;
+			std::vector<FNPtr> detached_fns;///< FNs that are deleted. Their children's ref_counts must be decremented.
+			EntrySubsets subsets;           ///< buffers for partitioning the entries of a FN by key part, reused for all FNs of the partition
+		};
 
 		UpdatePlan_t update_plan_;
 		ChildUpdateRequests_t child_update_requests_;
 		NodeStorage_t &node_storage_;
 		::robin_hood::unordered_set<RawIdentifier_t<depth>> done_fns_{};
+		size_t workers_;
 
 		auto &fns() {
 			return node_storage_.template nodes<depth, FullNode>().nodes();
@@ -173,36 +240,82 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		}
 
 	public:
+		/**
+		 * @param node_storage node storage to apply changes to
+		 * @param update_requests updates that are requested to be executed
+		 * @param workers maximum number of threads that write entries into FNs concurrently
+		 */
 		ApplyUpdate(NodeStorage_t &node_storage,
-					UpdateRequests_t &&update_requests)
+					UpdateRequests_t &&update_requests,
+					size_t workers = 1)
 			: update_plan_{std::move(update_requests)},
 			  child_update_requests_{node_storage},
-			  node_storage_{node_storage} {}
+			  node_storage_{node_storage},
+			  workers_{std::max(workers, size_t(1))} {}
 
 
 		/**
 		 * This executes applying the changes. The object is consumed in the process.
+		 *
+		 * All changes to the node storage maps and all (de)allocations of nodes are done by the calling thread.
+		 * Writing entries into FNs and registering the resulting changes for the next depth is independent per FN.
+		 * This part is split over up to workers_ threads, each collecting its own child update requests, which are merged afterwards.
 		 */
 		void consume_and_execute() && {
+			size_t const fn_changes = update_plan_.fn_create.size() + update_plan_.fn_update_copy.size() + update_plan_.fn_update_move.size() + update_plan_.fn_delete.size();
+			size_t const workers = std::clamp(fn_changes / min_fns_per_worker, size_t(1), workers_);
+			std::vector<WorkerPartition> partitions(workers);
+			auto partition_of = [&](RawIdentifier_t<depth> const &id) -> WorkerPartition & {
+				return partitions[id.hash() % workers];
+			};
+
 			// create new FNs from scratch or by promoting a SEN
 			for (FNCreation<depth> &fn_creation_plan : update_plan_.fn_create) {
-				create_fn(std::move(fn_creation_plan));
+				auto const id = fn_creation_plan.id;
+				partition_of(id).entries_jobs.push_back(create_fn(std::move(fn_creation_plan)));
 			}
 
 			// create new FNs by copy-inserting into existing FNs
 			for (FNEntriesUpdate<depth> &fn_entries_update : update_plan_.fn_update_copy) {
-				copy_update_fn_to_fn(std::move(fn_entries_update));
+				auto const id = fn_entries_update.target_id;
+				partition_of(id).entries_jobs.push_back(copy_fn(std::move(fn_entries_update)));
 			}
 
-
 			// create new FNs by move-inserting into existing FNs that will no longer be used
+			// note: this must happen after copying, because moved FNs might be the source of copies
 			for (FNEntriesUpdate<depth> &fn_entries_update : update_plan_.fn_update_move) {
-				move_update_fn_to_fn(std::move(fn_entries_update));
+				auto const id = fn_entries_update.target_id;
+				partition_of(id).entries_jobs.push_back(move_fn(std::move(fn_entries_update)));
 			}
 
-			// delete FNs that are no longer referenced
+			// detach FNs that are no longer referenced
 			for (auto id : update_plan_.fn_delete) {
-				delete_fn(id);
+				partition_of(id).detached_fns.push_back(detach_fn(id));
+			}
+
+			// write entries into the FNs and register the changes to the children
+			if (workers == 1) {
+				execute_partition(partitions[0], child_update_requests_);
+			} else {
+				std::vector<ChildUpdateRequests_t> workers_child_update_requests;
+				workers_child_update_requests.reserve(workers);
+				for (size_t worker = 0; worker < workers; ++worker)
+					workers_child_update_requests.emplace_back(node_storage_);
+
+				util::run_on_workers(workers, [&](size_t worker) {
+					execute_partition(partitions[worker], workers_child_update_requests[worker]);
+				});
+
+				if constexpr (depth > 1) {
+					for (auto &worker_child_update_requests : workers_child_update_requests)
+						child_update_requests_.merge(std::move(worker_child_update_requests));
+				}
+			}
+
+			// delete FNs that are no longer referenced
+			for (auto &partition : partitions) {
+				for (auto node : partition.detached_fns)
+					fn_lifecycle().delete_(node);
 			}
 
 			// update refcount of existing FNs that are not deleted. None of them will have a ref_count of 0 afterwards.
@@ -223,30 +336,60 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			}
 
 			if constexpr (depth > 1) {
-				ApplyUpdate<depth - 1, htt_t, allocator_type, max_depth>{node_storage_, std::move(child_update_requests_)}
+				ApplyUpdate<depth - 1, htt_t, allocator_type, max_depth>{node_storage_, std::move(child_update_requests_), workers_}
 						.consume_and_execute();
 			}
 		}
 
 	private:
-		void create_fn(FNCreation<depth> &&creation_plan) noexcept {
+		/**
+		 * Writes the entries into the FNs of partition and releases the children of detached FNs. Changes to child nodes are registered at child_update_requests.
+		 * Different partitions can be executed concurrently.
+		 */
+		void execute_partition(WorkerPartition &partition, ChildUpdateRequests_t &child_update_requests) {
+			for (auto &job : partition.entries_jobs) {
+				switch (job.origin) {
+					case NodeOrigin::JustCreated:
+						apply_fn_entry_insertion<NodeOrigin::JustCreated>(std::move(job.update), job.fn_ptr, child_update_requests, partition.subsets);
+						break;
+					case NodeOrigin::Copied:
+						apply_fn_entry_update<NodeOrigin::Copied>(std::move(job.update), job.fn_ptr, child_update_requests, partition.subsets);
+						job.fn_ptr->ref_count() = job.ref_count;
+						break;
+					case NodeOrigin::Moved:
+						apply_fn_entry_update<NodeOrigin::Moved>(std::move(job.update), job.fn_ptr, child_update_requests, partition.subsets);
+						job.fn_ptr->ref_count() = job.ref_count;
+						break;
+					default:
+						assert(false);
+				}
+			}
+
+			if constexpr (depth > 1) {
+				for (auto node : partition.detached_fns)
+					release_children(node, child_update_requests);
+			}
+		}
+
+		FNEntriesJob create_fn(FNCreation<depth> &&creation_plan) noexcept {
 			assert(!fns().contains(creation_plan.id));
 			assert(update_plan_.fn_deltas.at(creation_plan.id) > 0);
 			auto fn_ptr = fn_lifecycle().new_with_alloc(static_cast<size_t>(update_plan_.fn_deltas.at(creation_plan.id)));
 			done_fns_.insert(creation_plan.id);
 			fns().emplace(creation_plan.id, fn_ptr);
 
-			apply_fn_entry_insertion<NodeOrigin::JustCreated>(
-					FNEntriesUpdate<depth>{
+			return {.update = FNEntriesUpdate<depth>{
 							.source_id = {},
 							.target_id = creation_plan.id,
 							.entries = std::move(creation_plan.entries),
 							.mode = EntriesUpdateMode::INSERT},
-					fn_ptr);
+					.fn_ptr = fn_ptr,
+					.origin = NodeOrigin::JustCreated,
+					.ref_count = 0};
 		}
 
 
-		void copy_update_fn_to_fn(FNEntriesUpdate<depth> &&update) {
+		FNEntriesJob copy_fn(FNEntriesUpdate<depth> &&update) {
 			auto fn_ptr = [&]() {// copy the existing FN
 				assert(fns().contains(update.source_id));
 				assert(!fns().contains(update.target_id));
@@ -258,23 +401,10 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 
 			done_fns_.insert(update.target_id);
 			auto const ref_count = update_plan_.fn_deltas.at(update.target_id);
-
-			switch (update.mode) {
-				case EntriesUpdateMode::INSERT:
-					apply_fn_entry_insertion<NodeOrigin::Copied>(std::move(update), fn_ptr);
-					break;
-
-				case EntriesUpdateMode::ERASE:
-					apply_fn_entry_erasure<NodeOrigin::Copied>(std::move(update), fn_ptr);
-					break;
-				default:
-					assert(false);
-			}
-
-			fn_ptr->ref_count() = ref_count;
+			return {.update = std::move(update), .fn_ptr = fn_ptr, .origin = NodeOrigin::Copied, .ref_count = ref_count};
 		}
 
-		void move_update_fn_to_fn(FNEntriesUpdate<depth> &&update) {
+		FNEntriesJob move_fn(FNEntriesUpdate<depth> &&update) {
 			auto fn_ptr = [&]() {// detach the existing FN from node storage
 				assert(fns().contains(update.source_id));
 				assert(!fns().contains(update.target_id));
@@ -288,48 +418,55 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			done_fns_.insert(update.source_id);
 			done_fns_.insert(update.target_id);
 			auto const ref_count = update_plan_.fn_deltas.at(update.target_id);
+			return {.update = std::move(update), .fn_ptr = fn_ptr, .origin = NodeOrigin::Moved, .ref_count = ref_count};
+		}
 
+		template<NodeOrigin node_origin>
+		void apply_fn_entry_update(FNEntriesUpdate<depth> &&update, FNPtr fn_ptr, ChildUpdateRequests_t &child_update_requests, EntrySubsets &subsets) {
 			switch (update.mode) {
 				case EntriesUpdateMode::INSERT:
-					apply_fn_entry_insertion<NodeOrigin::Moved>(std::move(update), fn_ptr);
+					apply_fn_entry_insertion<node_origin>(std::move(update), fn_ptr, child_update_requests, subsets);
 					break;
 
 				case EntriesUpdateMode::ERASE:
-					apply_fn_entry_erasure<NodeOrigin::Moved>(std::move(update), fn_ptr);
+					apply_fn_entry_erasure<node_origin>(std::move(update), fn_ptr, child_update_requests, subsets);
+					break;
+
+				case EntriesUpdateMode::CHANGE:
+					if constexpr (!HypertrieTrait_bool_valued<htt_t>)
+						apply_fn_entry_change<node_origin>(std::move(update), fn_ptr, child_update_requests, subsets);
+					else
+						assert(false);
 					break;
 				default:
 					assert(false);
 			}
-			fn_ptr->ref_count() = ref_count;
 		}
 
-		void delete_fn(RawIdentifier_t<depth> const id) {
-
-			auto node = [&]() {// retrieve and detach node from node storage
-				assert(fns().contains(id));
-				auto iter = fns().find(id);
-				auto ret = container::deref(iter);
-				fns().erase(iter);// detach node
-				return ret;
-			}();
+		FNPtr detach_fn(RawIdentifier_t<depth> const id) {
+			assert(fns().contains(id));
+			auto iter = fns().find(id);
+			auto ret = container::deref(iter);
+			fns().erase(iter);
+			return ret;
+		}
 
-			if constexpr (depth > 1) {
-				// decrement refcount of all children, except inplace SENs
-				for (size_t pos = 0; pos < depth; ++pos) {
-					for (auto &[child_mapping_key_part, id_child] : node->edges(pos)) {
-						if constexpr (ht_hsi_depth2)
-							if (id_child.is_sen())
-								continue;
-						child_update_requests_.apply_ref_count_delta(id_child, -1);
-					}
+		void release_children(FNPtr node, ChildUpdateRequests_t &child_update_requests)
+			requires(depth > 1)
+		{
+			// decrement refcount of all children, except inplace SENs
+			for (size_t pos = 0; pos < depth; ++pos) {
+				for (auto const &[child_mapping_key_part, id_child] : node->edges(pos)) {
+					if constexpr (ht_hsi_depth2)
+						if (id_child.is_sen())
+							continue;
+					child_update_requests.apply_ref_count_delta(id_child, -1);
 				}
 			}
-
-			fn_lifecycle().delete_(node);
-		};
+		}
 
 		template<NodeOrigin node_origin>
-		void apply_fn_entry_insertion(FNEntriesUpdate<depth> &&update, FNPtr fn_ptr) {
+		void apply_fn_entry_insertion(FNEntriesUpdate<depth> &&update, FNPtr fn_ptr, ChildUpdateRequests_t &child_update_requests, [[maybe_unused]] EntrySubsets &subsets) {
 			assert(update.mode == EntriesUpdateMode::INSERT);
 
 			if constexpr (depth == 1) {
@@ -343,32 +480,32 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 					// foreach keypos
 
 					// populate newly_inserted_children
-					auto newly_inserted_children = entry_subset_for_pos(update.entries, pos);
+					subsets.partition(update.entries, pos);
 
 					// If a full_node is copied, some child mappings are altered some are added.
 					// For child mappings that stay the same the childs ref_count must be increased.
 					// Obviously, there is now a new full_node (this one) which references them.
 					if (node_origin == NodeOrigin::Copied) {
 						for (auto const &[child_mapping_key_part, id_child] : fn_ptr->edges(pos)) {
-							if (not newly_inserted_children.contains(child_mapping_key_part)) {
+							if (subsets.find(child_mapping_key_part) == nullptr) {
 								// child was here before
 
 								if constexpr (ht_hsi_depth2)
 									if (id_child.is_sen())
 										continue;// ignore inplace children
 
-								child_update_requests_.apply_ref_count_delta(id_child, 1);
+								child_update_requests.apply_ref_count_delta(id_child, 1);
 							}
 						}
 					}
 
-					for (auto &[key_part, child_inserted_entries] : newly_inserted_children) {
+					for (auto const &[key_part, child_inserted_entries, _] : subsets.subsets()) {
 						assert(child_inserted_entries.size() > 0);
 						if constexpr (node_origin != NodeOrigin::JustCreated) {
 							auto [child_exists, child_it] = fn_ptr->find(pos, key_part);
 							if (child_exists) {
 								// queue insert of child's children and set identifier
-								container::deref(child_it) = child_update_requests_.insert_into_node(container::deref(child_it), std::move(child_inserted_entries), node_origin == NodeOrigin::Moved);
+								container::deref(child_it) = child_update_requests.insert_into_node(container::deref(child_it), child_inserted_entries, node_origin == NodeOrigin::Moved);
 								continue;// child exists, no need to create new one further down
 							}
 						}
@@ -387,7 +524,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 						}
 
 						// if the child can not be inplace and there is more than 1 entry to be inserted => create node
-						edges[key_part] = child_update_requests_.add_node(std::move(child_inserted_entries));
+						edges[key_part] = child_update_requests.add_node(child_inserted_entries);
 					}
 				}
 			}
@@ -395,7 +532,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 
 
 		template<NodeOrigin node_origin>
-		void apply_fn_entry_erasure(FNEntriesUpdate<depth> &&update, FNPtr fn_ptr) {
+		void apply_fn_entry_erasure(FNEntriesUpdate<depth> &&update, FNPtr fn_ptr, ChildUpdateRequests_t &child_update_requests, [[maybe_unused]] EntrySubsets &subsets) {
 			assert(update.mode == EntriesUpdateMode::ERASE);
 
 			if constexpr (depth > 1) {
@@ -406,30 +543,29 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 				// apply changes to copy
 				for (size_t pos = 0; pos < depth; ++pos) {
 					auto &edges = fn_ptr->edges(pos);
+					subsets.partition(update.entries, pos);
 
 					if constexpr (node_origin == NodeOrigin::Copied) {
-						auto changes = entry_subset_for_pos(update.entries, pos);
-
 						for (auto edges_iter = edges.begin(); edges_iter != edges.end();) {
 							const key_part_type key_part = edges_iter->first;
 							auto &child_id = container::deref(edges_iter);
-							if (auto changes_iter = changes.find(key_part); changes_iter != changes.end()) {
-								child_id = child_update_requests_.remove_from_node(child_id, std::move(changes_iter->second), false);
+							if (auto const *subset = subsets.find(key_part); subset != nullptr) {
+								child_id = child_update_requests.remove_from_node(child_id, subset->entries, false);
 								if (child_id.empty()) {
 									edges_iter = edges.erase(edges_iter);
 									continue;
 								}
 							} else {
-								child_update_requests_.apply_ref_count_delta(child_id, 1);
+								child_update_requests.apply_ref_count_delta(child_id, 1);
 							}
 							++edges_iter;
 						}
 					} else {// NodeOrigin::Moved
-						for (auto &&[key_part, subset] : entry_subset_for_pos(update.entries, pos)) {
+						for (auto const &[key_part, subset, _] : subsets.subsets()) {
 							assert(edges.contains(key_part));
 							auto edges_iter = edges.find(key_part);
 							auto &child_id = container::deref(edges_iter);
-							child_id = child_update_requests_.remove_from_node(child_id, std::move(subset), true);
+							child_id = child_update_requests.remove_from_node(child_id, subset, true);
 							if (child_id.empty())
 								edges.erase(edges_iter);
 						}
@@ -447,6 +583,45 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			}
 		}
 
+		template<NodeOrigin node_origin>
+		void apply_fn_entry_change(FNEntriesUpdate<depth> &&update, FNPtr fn_ptr, ChildUpdateRequests_t &child_update_requests, [[maybe_unused]] EntrySubsets &subsets)
+			requires(!HypertrieTrait_bool_valued<htt_t>)
+		{
+			assert(update.mode == EntriesUpdateMode::CHANGE);
+			assert(update.entries.size() == update.old_entries.size());
+
+			if constexpr (depth > 1) {
+				// the size stays the same, only the children that hold the changed entries are changed as well
+				for (size_t pos = 0; pos < depth; ++pos) {
+					auto &edges = fn_ptr->edges(pos);
+					// old and new entries are partitioned alike, so the old and new subsets of a key part match entry by entry
+					subsets.partition(update.entries, update.old_entries, pos);
+
+					if constexpr (node_origin == NodeOrigin::Copied) {
+						for (auto edges_iter = edges.begin(); edges_iter != edges.end(); ++edges_iter) {
+							const key_part_type key_part = edges_iter->first;
+							auto &child_id = container::deref(edges_iter);
+							if (auto const *subset = subsets.find(key_part); subset != nullptr) {
+								child_id = child_update_requests.change_in_node(child_id, subset->old_entries, subset->entries, false);
+							} else {
+								child_update_requests.apply_ref_count_delta(child_id, 1);
+							}
+						}
+					} else {// NodeOrigin::Moved
+						for (auto const &[key_part, new_subset, old_subset] : subsets.subsets()) {
+							assert(edges.contains(key_part));
+							auto edges_iter = edges.find(key_part);
+							auto &child_id = container::deref(edges_iter);
+							child_id = child_update_requests.change_in_node(child_id, old_subset, new_subset, true);
+						}
+					}
+				}
+			} else {// depth == 1
+				for (auto const &entry : update.entries)
+					fn_ptr->insert_or_assign(entry.key(), entry.value());
+			}
+		}
+
 		void apply_sen_update(RawIdentifier_t<depth> node_id, SENChange &&update) noexcept {
 			assert(
 					[&]() {
@@ -0,0 +1,249 @@
+#ifndef HYPERTRIE_BULKLOAD_HPP
+#define HYPERTRIE_BULKLOAD_HPP
+
+#include "dice/hypertrie/ByteAllocator.hpp"
+#include "dice/hypertrie/Hypertrie_trait.hpp"
+#include "dice/hypertrie/internal/container/AllContainer.hpp"
+#include "dice/hypertrie/internal/raw/node/FullNode.hpp"
+#include "dice/hypertrie/internal/raw/node/Identifier.hpp"
+#include "dice/hypertrie/internal/raw/node/NodeContainer.hpp"
+#include "dice/hypertrie/internal/raw/node/NodeStorage.hpp"
+#include "dice/hypertrie/internal/raw/node/SingleEntry.hpp"
+#include "dice/hypertrie/internal/raw/node/SingleEntryNode.hpp"
+#include "dice/hypertrie/internal/raw/node_context/update_details/UpdateRequests.hpp"
+
+#include <robin_hood.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <ranges>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace dice::hypertrie::internal::raw::node_context::update_details {
+
+	/**
+	 * The nodes of a level that are to be built by BulkLoad, each with its sorted entries and the number of references to it.
+	 */
+	template<size_t depth, HypertrieTrait htt_t>
+	struct BulkLoadLevel {
+		struct PlannedNode {
+			RawIdentifier<depth, htt_t> id;
+			std::vector<SingleEntry<depth, htt_t>> entries;
+			size_t ref_count;
+		};
+
+		std::vector<PlannedNode> nodes;
+		::robin_hood::unordered_flat_map<RawIdentifier<depth, htt_t>, size_t> index;
+
+		/**
+		 * Adds a reference to the node with the given id. If the node is not yet planned, it is added with the entries returned by get_entries.
+		 */
+		template<typename GetEntries>
+		void add_ref(RawIdentifier<depth, htt_t> id, GetEntries &&get_entries) {
+			auto [iter, is_new] = index.try_emplace(id, nodes.size());
+			if (is_new)
+				nodes.push_back({id, std::forward<GetEntries>(get_entries)(), 1});
+			else
+				++nodes[iter->second].ref_count;
+		}
+	};
+
+	/**
+	 * Builds the nodes of a hypertrie from its entries directly, without planning updates against existing nodes (see ApplyUpdate).
+	 *
+	 * The nodes are built level by level from the root downwards. The nodes of a level are collected with their entries and
+	 * deduplicated by their identifiers before they are written to node storage. The identifier of a node is computed from its
+	 * entries by combining their hashes. A node that already exists in node storage is only referenced, its subtree is not built again.
+	 *
+	 * Entries of a node are kept sorted. Thereby, the children at position 0 are contiguous ranges of their parent's entries and
+	 * only the other positions need to be sorted.
+	 * @tparam depth depth of the nodes of this level
+	 */
+	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t max_depth>
+	struct BulkLoad {
+		static constexpr bool ht_hsi_depth1 = HTHSIDepth1<depth, htt_t>;
+		static constexpr bool ht_hsi_depth2 = HTHSIDepth2<depth, htt_t>;
+
+		using NodeStorage_t = NodeStorage<max_depth, htt_t, allocator_type>;
+		using SingleEntry_t = SingleEntry<depth, htt_t>;
+		using key_part_type = typename htt_t::key_part_type;
+		using Level = BulkLoadLevel<depth, htt_t>;
+		using PlannedNode = typename Level::PlannedNode;
+
+	private:
+		using ChildLoad_t = BulkLoad<depth - 1, htt_t, allocator_type, max_depth>;
+		using ChildLevel = std::conditional_t<(depth > 1), BulkLoadLevel<depth - 1, htt_t>, std::monostate>;
+		using ChildEntry = SingleEntry<depth - 1, htt_t>;
+
+		NodeStorage_t &node_storage_;
+		ChildLevel children_;
+		std::vector<std::pair<key_part_type, ChildEntry>> projection_buffer_;
+
+		auto &fns() {
+			return node_storage_.template nodes<depth, FullNode>().nodes();
+		}
+
+		auto &fn_lifecycle() {
+			return node_storage_.template nodes<depth, FullNode>().node_lifecycle();
+		}
+
+		auto &sens()
+			requires(!ht_hsi_depth1)
+		{
+			return node_storage_.template nodes<depth, SingleEntryNode>().nodes();
+		}
+
+		auto &sens_lifecycle()
+			requires(!ht_hsi_depth1)
+		{
+			return node_storage_.template nodes<depth, SingleEntryNode>().node_lifecycle();
+		}
+
+	public:
+		explicit BulkLoad(NodeStorage_t &node_storage) noexcept : node_storage_(node_storage) {}
+
+		/**
+		 * Builds all nodes of level and of the levels below. The object is consumed in the process.
+		 * @param level the nodes to be built
+		 */
+		void build(Level &&level) && {
+			for (auto &planned : level.nodes) {
+				if (planned.id.is_sen())
+					build_sen(planned);
+				else
+					build_fn(planned);
+			}
+			level = {};
+
+			if constexpr (depth > 1) {
+				if (not children_.nodes.empty())
+					ChildLoad_t{node_storage_}.build(std::move(children_));
+			}
+		}
+
+	private:
+		void build_sen(PlannedNode const &planned) {
+			assert(planned.entries.size() == 1);
+			if constexpr (ht_hsi_depth1) {
+				// stored in-place, parents hold the entry
+				assert(false);
+			} else {
+				if (auto found = sens().find(planned.id); found != sens().end()) {
+					container::deref(found)->ref_count() += planned.ref_count;
+					return;
+				}
+				sens().emplace(planned.id, sens_lifecycle().new_(planned.entries.front(), planned.ref_count));
+			}
+		}
+
+		void build_fn(PlannedNode &planned) {
+			assert(planned.entries.size() > 1);
+			if (auto found = fns().find(planned.id); found != fns().end()) {
+				// the node and its subtree exist already
+				container::deref(found)->ref_count() += planned.ref_count;
+				return;
+			}
+
+			auto fn_ptr = fn_lifecycle().new_with_alloc(planned.ref_count);
+			if constexpr (depth == 1) {
+				fn_ptr->edges().reserve(planned.entries.size());
+				for (auto const &entry : planned.entries)
+					fn_ptr->insert_or_assign(entry.key(), entry.value());
+			} else {
+				fn_ptr->size() = planned.entries.size();
+				for (size_t pos = 0; pos < depth; ++pos)
+					build_edges(*fn_ptr, pos, planned.entries);
+			}
+			fns().emplace(planned.id, fn_ptr);
+		}
+
+		template<typename FN>
+		void build_edges(FN &fn, size_t pos, std::vector<SingleEntry_t> const &entries)
+			requires(depth > 1)
+		{
+			auto &projection = projection_buffer_;
+			projection.clear();
+			projection.reserve(entries.size());
+			for (auto const &entry : entries)
+				projection.emplace_back(entry.key()[pos], ChildEntry{entry.key().subkey(pos), entry.value()});
+			// entries are sorted, so the projection to position 0 is sorted as well
+			if (pos != 0)
+				std::sort(projection.begin(), projection.end());
+
+			auto &edges = fn.edges(pos);
+			size_t children = 1;
+			for (size_t i = 1; i < projection.size(); ++i)
+				children += (projection[i].first != projection[i - 1].first);
+			edges.reserve(children);
+
+			for (auto group_begin = projection.begin(); group_begin != projection.end();) {
+				auto const key_part = group_begin->first;
+				auto group_end = std::find_if(group_begin, projection.end(), [&](auto const &projected) { return projected.first != key_part; });
+				auto child_entries = std::ranges::subrange(group_begin, group_end) | std::views::elements<1>;
+				group_begin = group_end;
+
+				RawIdentifier<depth - 1, htt_t> child_id{child_entries};
+				edges[key_part] = child_id;
+				if constexpr (ht_hsi_depth2) {
+					if (child_id.is_sen())
+						continue;// the child is stored in-place
+				}
+				// entries are only copied for children that are not planned yet
+				children_.add_ref(child_id, [&]() { return std::vector<ChildEntry>(child_entries.begin(), child_entries.end()); });
+			}
+		}
+	};
+
+	/**
+	 * Builds a node from entries without planning updates (see BulkLoad). This is faster than inserting the entries into an empty node.
+	 * @param node_storage node storage where the nodes are built
+	 * @param nodec must be empty. Is set to the built node.
+	 * @param entries the entries of the node. Duplicates are removed. If entries are sorted (e.g. from an externally sorted stream), they are not sorted again.
+	 */
+	template<size_t depth, HypertrieTrait htt_t, ByteAllocator allocator_type, size_t max_depth>
+	void load_entries_into_empty_node(NodeStorage<max_depth, htt_t, allocator_type> &node_storage,
+									  NodeContainer<depth, htt_t, allocator_type> &nodec,
+									  std::vector<SingleEntry<depth, htt_t>> &&entries) {
+		using BulkLoad_t = BulkLoad<depth, htt_t, allocator_type, max_depth>;
+		assert(nodec.empty());
+		assert(std::ranges::all_of(entries, [](auto &entry) {
+			return std::ranges::all_of(entry.key(), [](auto &key_part) { return key_part != typename htt_t::key_part_type{}; });
+		}));
+		assert(std::ranges::all_of(entries, [](auto &entry) {
+			return entry.value() != typename htt_t::value_type{};
+		}));
+
+		if (not std::ranges::is_sorted(entries))
+			std::ranges::sort(entries);
+		// for multiple values per key, the smallest is kept
+		auto const duplicates = std::ranges::unique(entries, [](auto const &lhs, auto const &rhs) { return lhs.key() == rhs.key(); });
+		entries.erase(duplicates.begin(), duplicates.end());
+		if (entries.empty())
+			return;
+
+		RawIdentifier<depth, htt_t> const id{std::views::all(entries)};
+		if constexpr (HTHSIDepth1<depth, htt_t>) {
+			if (id.is_sen()) {
+				// value is inplace, no node is stored
+				nodec = SENContainer<depth, htt_t, allocator_type>{id};
+				return;
+			}
+		}
+
+		BulkLoadLevel<depth, htt_t> root;
+		root.add_ref(id, [&]() { return std::move(entries); });
+		BulkLoad_t{node_storage}.build(std::move(root));
+		if constexpr (HTHSIDepth1<depth, htt_t>) {
+			nodec = FNContainer<depth, htt_t, allocator_type>{id, node_storage.template lookup<depth, FullNode>(id)};
+		} else {
+			nodec = node_storage.template lookup<depth>(id);
+		}
+		assert(not nodec.is_null_ptr());
+	}
+
+}// namespace dice::hypertrie::internal::raw::node_context::update_details
+
+#endif//HYPERTRIE_BULKLOAD_HPP
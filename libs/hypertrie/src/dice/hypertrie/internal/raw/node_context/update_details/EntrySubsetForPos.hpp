@@ -4,24 +4,163 @@
 #include "dice/hypertrie/Hypertrie_trait.hpp"
 #include "dice/hypertrie/internal/raw/node/SingleEntry.hpp"
 
-#include <robin_hood.h>
-
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace dice::hypertrie::internal::raw::node_context::update_details {
 
-
+	/**
+	 * Partitions entries by their key part at a position. The subkeys (entries without the key part at pos) are written to a
+	 * contiguous buffer, grouped by key part. Each group is exposed as a span. Within a group, entries keep their order.
+	 *
+	 * The buffers are reused by subsequent calls of partition. Thus, spans returned by an earlier call are invalidated.
+	 * Unsigned integral key parts are radix-partitioned if there are many entries, other key parts are sorted.
+	 * @tparam depth depth of the entries that are partitioned
+	 */
 	template<size_t depth, HypertrieTrait htt_t>
-	auto entry_subset_for_pos(std::vector<SingleEntry<depth, htt_t>> const &entries, size_t pos) noexcept
-			-> ::robin_hood::unordered_map<typename htt_t::key_part_type, std::vector<SingleEntry<(depth - 1), htt_t>>> {
-		::robin_hood::unordered_map<typename htt_t::key_part_type, std::vector<SingleEntry<(depth - 1), htt_t>>> ret;
+	class EntrySubsetsForPos {
+		static_assert(depth > 1);
+
+	public:
+		using key_part_type = typename htt_t::key_part_type;
+		using SingleEntry_t = SingleEntry<depth, htt_t>;
+		using SubEntry_t = SingleEntry<depth - 1, htt_t>;
+
+		/**
+		 * The entries with the same key part at the partitioned position.
+		 */
+		struct Subset {
+			key_part_type key_part;
+			std::span<SubEntry_t const> entries;
+			std::span<SubEntry_t const> old_entries;///< only set by partition with old_entries
+		};
+
+		/**
+		 * Minimal number of entries for which radix partitioning is used instead of sorting.
+		 */
+		static constexpr size_t min_radix_entries = 512;
+
+	private:
+		static constexpr bool radix_partitionable = std::unsigned_integral<key_part_type>;
+		static constexpr size_t radix_bits = 8;
+		static constexpr size_t radix_buckets = size_t(1) << radix_bits;
+		static constexpr size_t radix_passes = (sizeof(key_part_type) * 8 + radix_bits - 1) / radix_bits;
+
+		using Ordered = std::pair<key_part_type, uint32_t>;
+
+		std::vector<Ordered> order_;
+		std::vector<Ordered> order_buffer_;
+		std::vector<SubEntry_t> entries_;
+		std::vector<SubEntry_t> old_entries_;
+		std::vector<Subset> subsets_;
+
+	public:
+		/**
+		 * Partitions entries by their key part at pos.
+		 */
+		void partition(std::span<SingleEntry_t const> entries, size_t pos) {
+			partition(entries, {}, pos);
+		}
+
+		/**
+		 * Partitions entries and old_entries alike by their key part at pos. old_entries must have the same keys as entries in the same order.
+		 */
+		void partition(std::span<SingleEntry_t const> entries, std::span<SingleEntry_t const> old_entries, size_t pos) {
+			assert(pos < depth);
+			assert(old_entries.empty() or old_entries.size() == entries.size());
+			order_.clear();
+			order_.reserve(entries.size());
+			for (uint32_t i = 0; i < entries.size(); ++i)
+				order_.emplace_back(entries[i].key()[pos], i);
+			sort_stable();
+
+			entries_.clear();
+			entries_.reserve(entries.size());
+			old_entries_.clear();
+			old_entries_.reserve(old_entries.size());
+			for (auto const &[key_part, i] : order_) {
+				entries_.emplace_back(entries[i].key().subkey(pos), entries[i].value());
+				if (not old_entries.empty())
+					old_entries_.emplace_back(old_entries[i].key().subkey(pos), old_entries[i].value());
+			}
+
+			subsets_.clear();
+			for (size_t begin = 0; begin < order_.size();) {
+				auto const key_part = order_[begin].first;
+				size_t end = begin + 1;
+				while (end < order_.size() and order_[end].first == key_part)
+					++end;
+				std::span<SubEntry_t const> group_old_entries{};
+				if (not old_entries.empty())
+					group_old_entries = std::span<SubEntry_t const>{old_entries_}.subspan(begin, end - begin);
+				subsets_.push_back({key_part, std::span<SubEntry_t const>{entries_}.subspan(begin, end - begin), group_old_entries});
+				begin = end;
+			}
+		}
+
+		/**
+		 * @return the subsets of the last partition, ordered by key part
+		 */
+		[[nodiscard]] std::span<Subset const> subsets() const noexcept { return subsets_; }
+
+		/**
+		 * @return the subset for key_part or nullptr if no entry has key_part at the partitioned position
+		 */
+		[[nodiscard]] Subset const *find(key_part_type const &key_part) const noexcept {
+			auto iter = std::ranges::lower_bound(subsets_, key_part, {}, &Subset::key_part);
+			if (iter == subsets_.end() or iter->key_part != key_part)
+				return nullptr;
+			return &*iter;
+		}
+
+	private:
+		/**
+		 * Sorts order_ by key part. Entries with equal key parts keep their order.
+		 */
+		void sort_stable() {
+			if constexpr (radix_partitionable) {
+				if (order_.size() >= min_radix_entries) {
+					radix_sort();
+					return;
+				}
+			}
+			// the second element is the original index, so equal key parts stay in order
+			std::ranges::sort(order_);
+		}
+
+		/**
+		 * LSD radix sort. Passes over digits that are equal for all key parts are skipped.
+		 */
+		void radix_sort()
+			requires radix_partitionable
+		{
+			std::array<std::array<size_t, radix_buckets>, radix_passes> histograms{};
+			for (auto const &[key_part, _] : order_) {
+				for (size_t pass = 0; pass < radix_passes; ++pass)
+					++histograms[pass][(key_part >> (pass * radix_bits)) & (radix_buckets - 1)];
+			}
 
-		for (auto const &e : entries) {
-			ret[e.key()[pos]].emplace_back(e.key().subkey(pos), e.value());
+			order_buffer_.resize(order_.size());
+			for (size_t pass = 0; pass < radix_passes; ++pass) {
+				auto &histogram = histograms[pass];
+				if (std::ranges::any_of(histogram, [&](size_t count) { return count == order_.size(); }))
+					continue;// all key parts share this digit
+				size_t offset = 0;
+				for (auto &count : histogram)
+					offset += std::exchange(count, offset);
+				for (auto const &ordered : order_)
+					order_buffer_[histogram[(ordered.first >> (pass * radix_bits)) & (radix_buckets - 1)]++] = ordered;
+				order_.swap(order_buffer_);
+			}
 		}
+	};
 
-		return ret;
-	}
 }// namespace dice::hypertrie::internal::raw::node_context::update_details
 #endif//ENTRYSUBSETFORPOS_HPP
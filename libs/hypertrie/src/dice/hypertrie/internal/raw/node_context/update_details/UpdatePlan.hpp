@@ -49,6 +49,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			RawIdentifier_t target_id;
 			std::vector<SingleEntry_t> entries;
 			EntriesUpdateMode mode;
+			std::vector<SingleEntry_t> old_entries;///< only for EntriesUpdateMode::CHANGE
 		};
 
 		struct FNEntriesInsertion : FNEntriesUpdate {};
@@ -125,7 +126,8 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 						FNEntriesUpdate fn_entries_update{.source_id = source_id,
 														  .target_id = target_id,
 														  .entries = std::move(update_req.entries),
-														  .mode = update_req.mode};
+														  .mode = update_req.mode,
+														  .old_entries = std::move(update_req.old_entries)};
 						if (move_one_source) {
 							// source is listed to be deleted and target is listed to be created. So, source can be reused to create target
 							fn_update_move.emplace_back(std::move(fn_entries_update));
@@ -14,6 +14,7 @@
 #include <cassert>
 #include <cstddef>
 #include <optional>
+#include <span>
 #include <type_traits>
 #include <vector>
 
@@ -30,7 +31,8 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 
 	enum struct EntriesUpdateMode : uint8_t {
 		INSERT,
-		ERASE
+		ERASE,
+		CHANGE///< values of contained entries are changed. Only for non-Boolean valued hypertries.
 	};
 
 	/**
@@ -60,8 +62,9 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		};
 
 		struct FNEntriesUpdateData {
-			std::vector<SingleEntry_t> entries;///< entries to be inserted
-			EntriesUpdateMode mode;            ///< if the entries are inserted or erased
+			std::vector<SingleEntry_t> entries;    ///< entries to be inserted, erased or (for CHANGE) the entries with their new values
+			EntriesUpdateMode mode;                ///< if the entries are inserted, erased or changed
+			std::vector<SingleEntry_t> old_entries;///< only for CHANGE: the entries with their old values, in the same order as entries
 		};
 
 	private:
@@ -121,7 +124,14 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		UpdateRequests(NodeStorage_t const &node_storage)
 			: node_storage_{node_storage} {}
 
-		RawIdentifier_t add_node(std::vector<SingleEntry_t> &&entries, ssize_t n = 1) noexcept {
+		/**
+		 * Request the creation of a node from entries.
+		 * @param entries the entries of the node
+		 * @param n ref_count delta of the node if it is a SEN
+		 * @param entry_hashes RawIdentifier_t::entry_hash of each entry, if already computed by the caller. Otherwise, they are computed.
+		 * @return the (possibly future) id of the node
+		 */
+		RawIdentifier_t add_node(std::span<SingleEntry_t const> entries, ssize_t n = 1, std::span<size_t const> entry_hashes = {}) noexcept {
 			assert(!entries.empty());
 			assert(std::ranges::all_of(entries, [](auto &entry) {
 				return std::ranges::all_of(entry.key(), [](auto &key_part) { return key_part != typename htt_t::key_part_type{}; });
@@ -129,7 +139,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			assert(std::ranges::all_of(entries, [](auto &entry) {
 				return entry.value() != typename htt_t::value_type{};
 			}));
-			RawIdentifier_t id_after{entries};
+			auto const id_after = identify(entries, entry_hashes);
 			if (entries.size() == 1) {
 				if constexpr (ht_hsi_depth1) {
 					return id_after;
@@ -139,7 +149,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 					change.entry = entries[0];
 				}
 			} else {
-				fn_creations_.emplace(id_after, std::move(entries));
+				fn_creations_.try_emplace(id_after, entries.begin(), entries.end());
 				apply_ref_count_delta(id_after, 1);
 			}
 			return id_after;
@@ -148,11 +158,12 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		/**
 		 * Request the insertion of entries into the node with id source_id.
 		 * @param source_id id of the source node where entries are inserted
-		 * @param entries the entries to be inserted
+		 * @param entries the entries to be inserted. They are only copied if they are needed for the update.
 		 * @param node_before_needs_decrement if the ref_count of the source node needs to be decremented
+		 * @param entry_hashes RawIdentifier_t::entry_hash of each entry, if already computed by the caller. Otherwise, they are computed.
 		 * @return the (possibly future) id of the target node
 		 */
-		RawIdentifier_t insert_into_node(RawIdentifier_t source_id, std::vector<SingleEntry_t> &&entries, bool node_before_needs_decrement = false) noexcept {
+		RawIdentifier_t insert_into_node(RawIdentifier_t source_id, std::span<SingleEntry_t const> entries, bool node_before_needs_decrement = false, std::span<size_t const> entry_hashes = {}) noexcept {
 			assert(!entries.empty());
 			assert(!source_id.empty());
 			assert(std::ranges::all_of(entries, [](auto &entry) {
@@ -161,38 +172,45 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			assert(std::ranges::all_of(entries, [](auto &entry) {
 				return entry.value() != typename htt_t::value_type{};
 			}));
-			auto const target_id = RawIdentifier_t{entries}.combine(source_id);
+			auto const target_id = identify(entries, entry_hashes).combine(source_id);
 			apply_ref_count_delta(target_id, 1);// the target node is always a FN
 			if (source_id.is_sen()) {
 				// if the source is a SEN its entry is retrieved and added to entries
 				// from entries a new node is created
-				if constexpr (ht_hsi_depth1) {
-					// for in-place stored nodes the entry is stored directly in the source_id
-					entries.push_back(source_id.get_entry());
-				} else {
-					auto &sen_change = [&]() -> SENChange & {// retrieve or create the SEN change
-						if (auto found = sen_changes_.find(source_id); found != sen_changes_.end()) {
-							auto &ret = found->second;
+				auto const source_entry = [&]() -> SingleEntry_t {
+					if constexpr (ht_hsi_depth1) {
+						// for in-place stored nodes the entry is stored directly in the source_id
+						return source_id.get_entry();
+					} else {
+						auto &sen_change = [&]() -> SENChange & {// retrieve or create the SEN change
+							if (auto found = sen_changes_.find(source_id); found != sen_changes_.end()) {
+								auto &ret = found->second;
+								return ret;
+							}
+							assert(sens().contains(source_id));
+							auto &ret = sen_changes_[source_id];
+							ret.entry = *sens().at(source_id);
 							return ret;
+						}();
+						// decrement refcount delta of node before
+						if (node_before_needs_decrement) {
+							sen_change.ref_count_delta -= 1;
 						}
-						assert(sens().contains(source_id));
-						auto &ret = sen_changes_[source_id];
-						ret.entry = *sens().at(source_id);
-						return ret;
-					}();
-					// decrement refcount delta of node before
-					if (node_before_needs_decrement) {
-						sen_change.ref_count_delta -= 1;
-					}
-					// add the entry of the source SEN to entries
-					if (!sen_change.entry.has_value()) {
-						sen_change.entry = *sens().at(source_id);
+						// the entry of the source SEN is added to the entries of the new node
+						if (!sen_change.entry.has_value()) {
+							sen_change.entry = *sens().at(source_id);
+						}
+						return sen_change.entry.value();
 					}
-					entries.push_back(sen_change.entry.value());
-				}
+				}();
 				// register a new node to be created
-				// note: emplace inserts only if it doesn't exist yet
-				fn_creations_.emplace(target_id, std::move(entries));
+				if (not fn_creations_.contains(target_id)) {
+					std::vector<SingleEntry_t> node_entries;
+					node_entries.reserve(entries.size() + 1);
+					node_entries.assign(entries.begin(), entries.end());
+					node_entries.push_back(source_entry);
+					fn_creations_.emplace(target_id, std::move(node_entries));
+				}
 			} else {// source_id.is_fn()
 				if (node_before_needs_decrement) {
 					fn_move_target_candidates_.insert(target_id);
@@ -200,7 +218,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 				}
 				auto &changes = fn_update_entries_[source_id];
 				if (not changes.contains(target_id)) {
-					changes[target_id] = FNEntriesUpdateData{.entries = std::move(entries), .mode = EntriesUpdateMode::INSERT};
+					changes[target_id] = FNEntriesUpdateData{.entries = {entries.begin(), entries.end()}, .mode = EntriesUpdateMode::INSERT};
 				}
 			}
 
@@ -213,9 +231,10 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		 *
 		 * @param source_id the id of the node from which the entries are removed
 		 * @param entries the entries to be removed
+		 * @param entry_hashes RawIdentifier_t::entry_hash of each entry, if already computed by the caller. Otherwise, they are computed.
 		 * @return The ID that the node will have after insertion. If all entries are removed, an empty node is returned.
 		 */
-		RawIdentifier_t remove_from_node(RawIdentifier_t const source_id, std::vector<SingleEntry_t> &&entries, bool node_before_needs_decrement = false) noexcept {
+		RawIdentifier_t remove_from_node(RawIdentifier_t const source_id, std::span<SingleEntry_t const> entries, bool node_before_needs_decrement = false, std::span<size_t const> entry_hashes = {}) noexcept {
 			assert(!entries.empty());
 			assert(std::ranges::all_of(entries, [](auto &entry) {
 				return std::ranges::all_of(entry.key(), [](auto &key_part) { return key_part != typename htt_t::key_part_type{}; });
@@ -243,7 +262,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			}
 
 			// target_id value is provisional. Might be retagged to a single entry node or replaced by a in-place stored node (dpeth 1, hsi)
-			auto target_id = RawIdentifier_t{entries}.combine(source_id);
+			auto target_id = identify(entries, entry_hashes).combine(source_id);
 
 			if (node_before_needs_decrement) {
 				apply_ref_count_delta(source_id, -1);
@@ -264,7 +283,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 					if (auto found = sen_changes_.find(target_id); found != sen_changes_.end()) {
 						return RawIdentifier_t{found->second};
 					}
-					auto const entry = retrieve_remaining_single_entry(fn_ptr, std::move(entries));
+					auto const entry = retrieve_remaining_single_entry(fn_ptr, entries);
 					sen_changes_[target_id] = entry;
 					return RawIdentifier_t{entry};
 				} else {
@@ -286,7 +305,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 					// third, calculate the remaining entry and add it to sen_changes_
 					sen_changes_[target_id] = {
 							.ref_count_delta = 1,
-							.entry = retrieve_remaining_single_entry(fn_ptr, std::move(entries))};
+							.entry = retrieve_remaining_single_entry(fn_ptr, entries)};
 					assert(RawIdentifier_t{sen_changes_[target_id].entry.value()} == target_id);
 					return target_id;
 				}
@@ -297,7 +316,8 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 				fn_move_target_candidates_.insert(target_id);
 				auto &changes = fn_update_entries_[source_id];
 				// note: only inserted if no FNUpdate for source_id -> target_id exists already
-				changes.emplace(target_id, FNEntriesUpdateData{.entries = std::move(entries), .mode = EntriesUpdateMode::ERASE});
+				if (not changes.contains(target_id))
+					changes.emplace(target_id, FNEntriesUpdateData{.entries = {entries.begin(), entries.end()}, .mode = EntriesUpdateMode::ERASE});
 				return target_id;
 			}
 
@@ -305,6 +325,64 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			return {};
 		}
 
+		/**
+		 * Change the values of entries of a node and return the resulting identifier. The size of the node does not change.
+		 *
+		 * @param source_id the id of the node that contains old_entries
+		 * @param old_entries the entries with their current values
+		 * @param new_entries the same keys as old_entries in the same order, but with the new values. The values must differ from the old ones.
+		 * @param node_before_needs_decrement if the ref_count of the source node needs to be decremented
+		 * @return the (possibly future) id of the target node
+		 */
+		RawIdentifier_t change_in_node(RawIdentifier_t const source_id,
+									   std::span<SingleEntry_t const> old_entries,
+									   std::span<SingleEntry_t const> new_entries,
+									   bool node_before_needs_decrement = false) noexcept
+			requires(!HypertrieTrait_bool_valued<htt_t>)
+		{
+			assert(!new_entries.empty());
+			assert(!source_id.empty());
+			assert(old_entries.size() == new_entries.size());
+			assert(std::ranges::equal(old_entries, new_entries, [](auto const &old_entry, auto const &new_entry) {
+				return old_entry.key() == new_entry.key() and old_entry.value() != new_entry.value();
+			}));
+			assert(std::ranges::all_of(new_entries, [](auto &entry) {
+				return entry.value() != typename htt_t::value_type{};
+			}));
+
+			if (source_id.is_sen()) {
+				assert(new_entries.size() == 1);
+				assert(static_cast<SingleEntry_t>(*sens().at(source_id)) == old_entries[0]);
+				RawIdentifier_t const target_id{new_entries[0]};
+				if (node_before_needs_decrement) {
+					auto &source_change = sen_changes_[source_id];
+					source_change.ref_count_delta -= 1;
+					source_change.entry = old_entries[0];
+				}
+				auto &target_change = sen_changes_[target_id];
+				target_change.ref_count_delta += 1;
+				target_change.entry = new_entries[0];
+				return target_id;
+			}
+
+			auto target_id = source_id;
+			for (size_t i = 0; i < new_entries.size(); ++i)
+				target_id.changeValue(old_entries[i], new_entries[i].value());
+
+			apply_ref_count_delta(target_id, 1);
+			if (node_before_needs_decrement) {
+				fn_move_target_candidates_.insert(target_id);
+				apply_ref_count_delta(source_id, -1);
+			}
+			auto &changes = fn_update_entries_[source_id];
+			// note: only inserted if no FNUpdate for source_id -> target_id exists already
+			if (not changes.contains(target_id))
+				changes.emplace(target_id, FNEntriesUpdateData{.entries = {new_entries.begin(), new_entries.end()},
+															   .mode = EntriesUpdateMode::CHANGE,
+															   .old_entries = {old_entries.begin(), old_entries.end()}});
+			return target_id;
+		}
+
 		/**
 		 * Add a delta to the ref_count of the node identified by id. The user must make sure that the ref_count will not become negative.
 		 * @param id id of node where ref_count should be altered
@@ -327,7 +405,48 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 			}
 		}
 
+		/**
+		 * Add all requests from other to this. The result is the same as if all requests to other had been made on this.
+		 * This is used to combine requests that were collected independently, e.g., by different workers.
+		 * @param other requests to be merged into this; consumed in the process
+		 */
+		void merge(UpdateRequests &&other) noexcept {
+			for (auto &[id, change] : other.sen_changes_) {
+				if constexpr (ht_hsi_depth1) {
+					sen_changes_.emplace(id, change);
+				} else {
+					auto &own_change = sen_changes_[id];
+					own_change.ref_count_delta += change.ref_count_delta;
+					if (!own_change.entry.has_value())
+						own_change.entry = std::move(change.entry);
+				}
+			}
+			for (auto &[source_id, targets] : other.fn_update_entries_) {
+				auto &own_targets = fn_update_entries_[source_id];
+				for (auto &[target_id, update_data] : targets)
+					own_targets.emplace(target_id, std::move(update_data));
+			}
+			for (auto &[id, entries] : other.fn_creations_)
+				fn_creations_.emplace(id, std::move(entries));
+			for (auto const &[id, ref_count_delta] : other.fn_deltas_)
+				fn_deltas_[id] += ref_count_delta;
+			for (auto const &id : other.fn_deletion_candidates_)
+				fn_deletion_candidates_.insert(id);
+			for (auto const &id : other.fn_move_target_candidates_)
+				fn_move_target_candidates_.insert(id);
+			for (auto const &id : other.fn_potentially_new_)
+				fn_potentially_new_.insert(id);
+		}
+
 	private:
+		static RawIdentifier_t identify(std::span<SingleEntry_t const> entries, std::span<size_t const> entry_hashes) noexcept {
+			if (entry_hashes.empty())
+				return RawIdentifier_t{entries};
+			assert(entry_hashes.size() == entries.size());
+			assert(std::ranges::equal(entries, entry_hashes, {}, &RawIdentifier_t::entry_hash));
+			return RawIdentifier_t{entries, entry_hashes};
+		}
+
 		auto const &fns() const {
 			return node_storage_.template nodes<depth, FullNode>().nodes();
 		}
@@ -340,8 +459,8 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 
 		template<size_t depth2>
 		SingleEntry<depth2, htt_t> retrieve_remaining_single_entry(FNPtr_t<depth2> fn_ptr,
-																   std::vector<SingleEntry<depth2, htt_t>> &&entries) {
-			auto entry = retrieve_remaining_single_entry_impl(fn_ptr, std::move(entries)).value();
+																   std::span<SingleEntry<depth2, htt_t> const> entries) {
+			auto entry = retrieve_remaining_single_entry_impl(fn_ptr, entries).value();
 			assert(
 					std::ranges::all_of(entry.key(), [](auto &key_part) { return key_part != typename htt_t::key_part_type{}; }));
 			assert(entry.value() != typename htt_t::value_type{});
@@ -349,7 +468,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 		}
 		template<size_t depth2>
 		std::optional<SingleEntry<depth2, htt_t>> retrieve_remaining_single_entry_impl(FNPtr_t<depth2> fn_ptr,
-																					   std::vector<SingleEntry<depth2, htt_t>> &&entries) noexcept {
+																					   std::span<SingleEntry<depth2, htt_t> const> entries) noexcept {
 			static_assert(depth2 > 0);
 			auto const cards = fn_ptr->getCards();
 
@@ -382,19 +501,19 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 					return res;
 				};
 
-				auto removed_parts = entry_subset_for_pos(entries, pos);
-
+				EntrySubsetsForPos<depth2, htt_t> removed_parts;
+				removed_parts.partition(entries, pos);
 
 				for (auto const &[key_part, child_id] : fn_ptr->edges(pos)) {
-					auto iter = removed_parts.find(key_part);
-					if (iter == removed_parts.end()) {
+					auto const *removed = removed_parts.find(key_part);
+					if (removed == nullptr) {
 						if constexpr (depth2 == 2 && HypertrieTrait_bool_valued_and_taggable_key_part<htt_t>) {
 							return combine_res(key_part, pos, child_id.get_entry());
 						} else {
 							return combine_res(key_part, pos, static_cast<SingleEntry<depth2 - 1, htt_t>>(*node_storage_.template lookup<(depth2 - 1), SingleEntryNode>(child_id)));
 						}
 					}
-					auto &&next_entries = std::move(iter->second);
+					auto const next_entries = removed->entries;
 					if (child_id.is_sen()) {
 						assert((RawIdentifier<depth2 - 1, htt_t>{next_entries} == child_id));
 						continue;
@@ -402,7 +521,7 @@ namespace dice::hypertrie::internal::raw::node_context::update_details {
 					assert(child_id.is_fn() && !child_id.empty());
 
 					auto child_fn_ptr = node_storage_.template lookup<(depth2 - 1), FullNode>(child_id);
-					auto const sub_entry = retrieve_remaining_single_entry_impl<depth2 - 1>(child_fn_ptr, std::move(next_entries));
+					auto const sub_entry = retrieve_remaining_single_entry_impl<depth2 - 1>(child_fn_ptr, next_entries);
 					if (sub_entry.has_value())
 						return combine_res(key_part, pos, sub_entry.value());
 				}
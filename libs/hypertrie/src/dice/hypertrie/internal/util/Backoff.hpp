@@ -0,0 +1,107 @@
+#ifndef HYPERTRIE_BACKOFF_HPP
+#define HYPERTRIE_BACKOFF_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace dice::hypertrie::internal::util {
+
+	/**
+	 * How a thread waits for a condition that is established by another thread (see WaitSignal).
+	 * It first polls the condition spins times, then yields yields times and then parks until it is notified.
+	 * Spinning reacts fastest, parking does not use any CPU time.
+	 */
+	struct BackoffSettings {
+		/**
+		 * Number of busy polls before the thread starts to yield.
+		 */
+		uint32_t spins = 256;
+		/**
+		 * Number of polls with a yield in between before the thread parks.
+		 */
+		uint32_t yields = 16;
+		/**
+		 * If false, the thread never parks but keeps yielding.
+		 */
+		bool park = true;
+
+		/**
+		 * Only spins, i.e. never gives up the CPU. This is the behavior of the bulk updaters before backoff was introduced.
+		 */
+		static constexpr BackoffSettings busy_wait() noexcept { return {UINT32_MAX, 0, false}; }
+	};
+
+	/**
+	 * Hints the CPU that the calling thread is busy waiting.
+	 */
+	inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+		_mm_pause();
+#elif defined(__aarch64__)
+		asm volatile("yield");
+#endif
+	}
+
+	/**
+	 * Lets threads wait for a condition with backoff (see BackoffSettings) and wakes parked threads up when it may have become true.
+	 * Parking uses std::atomic::wait. notify() only issues a wake up if a thread is parked. Thus, it is cheap if nobody waits.
+	 */
+	class WaitSignal {
+		std::atomic<uint32_t> epoch_ = 0;
+		std::atomic<uint32_t> parked_ = 0;
+
+	public:
+		/**
+		 * Returns as soon as ready() returns true. ready() may be called many times and from the calling thread only.
+		 * A thread that establishes the condition must call notify() afterwards.
+		 * @param ready predicate for the condition
+		 * @param settings how to wait
+		 */
+		template<typename Ready>
+		void wait_until(Ready &&ready, BackoffSettings const &settings) noexcept {
+			for (uint32_t i = 0; i < settings.spins; ++i) {
+				if (ready())
+					return;
+				cpu_relax();
+			}
+			for (uint32_t i = 0; i < settings.yields or not settings.park; ++i) {
+				if (ready())
+					return;
+				std::this_thread::yield();
+			}
+			while (true) {
+				auto const epoch = epoch_.load(std::memory_order_acquire);
+				parked_.fetch_add(1, std::memory_order_seq_cst);
+				// pairs with the fence in notify(): either ready() sees the condition or notify() sees this thread parked
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				if (ready()) {
+					parked_.fetch_sub(1, std::memory_order_relaxed);
+					return;
+				}
+				epoch_.wait(epoch, std::memory_order_acquire);
+				parked_.fetch_sub(1, std::memory_order_relaxed);
+				if (ready())
+					return;
+			}
+		}
+
+		/**
+		 * Wakes up all threads that are parked in wait_until. Must be called after a condition that threads may wait for was established.
+		 */
+		void notify() noexcept {
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (parked_.load(std::memory_order_relaxed) != 0) {
+				epoch_.fetch_add(1, std::memory_order_release);
+				epoch_.notify_all();
+			}
+		}
+	};
+
+}// namespace dice::hypertrie::internal::util
+
+#endif//HYPERTRIE_BACKOFF_HPP
@@ -0,0 +1,140 @@
+#ifndef HYPERTRIE_EPOCHMANAGER_HPP
+#define HYPERTRIE_EPOCHMANAGER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <thread>
+#include <utility>
+
+namespace dice::hypertrie::internal::util {
+
+	/**
+	 * Epoch-based reclamation.
+	 * Readers pin the current epoch before they access shared objects and unpin it when they are done.
+	 * A writer that unlinks an object calls advance() and tags the object with the returned epoch.
+	 * The object may be reclaimed as soon as min_pinned() is larger than its tag,
+	 * because all readers that could have seen it have unpinned since.
+	 *
+	 * Pinning and unpinning are lock-free as long as less than max_pins readers are pinned at the same time.
+	 */
+	class EpochManager {
+	public:
+		using epoch_type = uint64_t;
+		static constexpr size_t max_pins = 128;
+
+	private:
+		static constexpr epoch_type unpinned = 0;
+
+		struct alignas(64) Slot {
+			std::atomic<epoch_type> epoch = unpinned;
+		};
+
+		std::atomic<epoch_type> global_epoch_ = 1;
+		std::array<Slot, max_pins> slots_{};
+
+	public:
+		/**
+		 * RAII handle of a pinned epoch. While it exists, no object that was reachable at epoch() is reclaimed.
+		 */
+		class Pin {
+			friend class EpochManager;
+
+			EpochManager *epoch_manager_ = nullptr;
+			size_t slot_ = 0;
+			epoch_type epoch_ = unpinned;
+
+			Pin(EpochManager *epoch_manager, size_t slot, epoch_type epoch) noexcept
+				: epoch_manager_(epoch_manager), slot_(slot), epoch_(epoch) {}
+
+		public:
+			Pin() noexcept = default;
+			Pin(Pin const &) = delete;
+			Pin &operator=(Pin const &) = delete;
+
+			Pin(Pin &&other) noexcept
+				: epoch_manager_(std::exchange(other.epoch_manager_, nullptr)), slot_(other.slot_), epoch_(other.epoch_) {}
+
+			Pin &operator=(Pin &&other) noexcept {
+				if (this != &other) {
+					release();
+					epoch_manager_ = std::exchange(other.epoch_manager_, nullptr);
+					slot_ = other.slot_;
+					epoch_ = other.epoch_;
+				}
+				return *this;
+			}
+
+			~Pin() noexcept {
+				release();
+			}
+
+			/**
+			 * Unpins the epoch. Called by the destructor.
+			 */
+			void release() noexcept {
+				if (epoch_manager_ != nullptr) {
+					epoch_manager_->slots_[slot_].epoch.store(unpinned);
+					epoch_manager_ = nullptr;
+				}
+			}
+
+			[[nodiscard]] epoch_type epoch() const noexcept { return epoch_; }
+
+			[[nodiscard]] bool pinned() const noexcept { return epoch_manager_ != nullptr; }
+		};
+
+		EpochManager() noexcept = default;
+		EpochManager(EpochManager const &) = delete;
+		EpochManager(EpochManager &&) = delete;
+		EpochManager &operator=(EpochManager const &) = delete;
+		EpochManager &operator=(EpochManager &&) = delete;
+
+		/**
+		 * Pins the current epoch. If all slots are taken, it waits until one is released.
+		 */
+		[[nodiscard]] Pin pin() noexcept {
+			size_t slot = std::hash<std::thread::id>{}(std::this_thread::get_id()) % max_pins;
+			epoch_type epoch = global_epoch_.load();
+			for (size_t tries = 0;; ++tries, slot = (slot + 1) % max_pins) {
+				epoch_type expected = unpinned;
+				if (slots_[slot].epoch.compare_exchange_strong(expected, epoch))
+					break;
+				if (tries != 0 and tries % max_pins == 0)
+					std::this_thread::yield();
+			}
+			// the writer might have advanced the epoch before it could see our slot
+			for (epoch_type current = global_epoch_.load(); current != epoch; current = global_epoch_.load()) {
+				epoch = current;
+				slots_[slot].epoch.store(epoch);
+			}
+			return Pin{this, slot, epoch};
+		}
+
+		/**
+		 * Starts a new epoch.
+		 * @return the epoch that ended; objects that were unlinked before the call are tagged with it
+		 */
+		epoch_type advance() noexcept {
+			return global_epoch_.fetch_add(1);
+		}
+
+		/**
+		 * @return the oldest pinned epoch or the maximum epoch_type if no epoch is pinned
+		 */
+		[[nodiscard]] epoch_type min_pinned() const noexcept {
+			epoch_type min = std::numeric_limits<epoch_type>::max();
+			for (auto const &slot : slots_) {
+				auto const epoch = slot.epoch.load();
+				if (epoch != unpinned and epoch < min)
+					min = epoch;
+			}
+			return min;
+		}
+	};
+
+}// namespace dice::hypertrie::internal::util
+
+#endif//HYPERTRIE_EPOCHMANAGER_HPP
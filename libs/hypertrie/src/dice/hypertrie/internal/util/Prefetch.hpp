@@ -0,0 +1,54 @@
+#ifndef HYPERTRIE_PREFETCH_HPP
+#define HYPERTRIE_PREFETCH_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace dice::hypertrie::internal::util {
+
+	/**
+	 * Size of a cache line as assumed by the prefetching helpers.
+	 */
+	inline constexpr std::size_t cache_line_size = 64;
+
+	/**
+	 * Hints the CPU to load the cache line at ptr for reading. Does nothing if the compiler does not support prefetching.
+	 * It is only a hint: ptr may be null or invalid.
+	 */
+	inline void prefetch(void const *ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+		__builtin_prefetch(ptr, 0, 3);
+#else
+		(void) ptr;
+#endif
+	}
+
+	/**
+	 * Hints the CPU to load the cache line that ptr points to. Fancy pointers (e.g., offset pointers) are converted to their address first.
+	 */
+	template<typename Pointer>
+	void prefetch_pointee(Pointer const &ptr) noexcept {
+		if constexpr (std::is_pointer_v<Pointer>)
+			prefetch(ptr);
+		else if (ptr != Pointer{})
+			prefetch(std::to_address(ptr));
+	}
+
+	/**
+	 * Hints the CPU to load all cache lines of the object that ptr points to. Null pointers are ignored.
+	 * Use this instead of prefetch_pointee for objects spanning several cache lines that are all read right away.
+	 */
+	template<typename Pointer>
+	void prefetch_whole_pointee(Pointer const &ptr) noexcept {
+		if (ptr == Pointer{})
+			return;
+		auto const *address = std::to_address(ptr);
+		auto const *bytes = reinterpret_cast<std::byte const *>(address);
+		for (std::size_t offset = 0; offset < sizeof(*address); offset += cache_line_size)
+			prefetch(bytes + offset);
+	}
+
+}// namespace dice::hypertrie::internal::util
+
+#endif//HYPERTRIE_PREFETCH_HPP
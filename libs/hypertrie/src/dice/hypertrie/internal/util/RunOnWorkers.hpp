@@ -0,0 +1,32 @@
+#ifndef HYPERTRIE_RUNONWORKERS_HPP
+#define HYPERTRIE_RUNONWORKERS_HPP
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace dice::hypertrie::internal::util {
+
+	/**
+	 * Calls worker_fn(worker_id) for every worker_id in [0, workers) concurrently and returns when all calls have finished.
+	 * The calling thread executes worker 0, so for workers <= 1 no thread is started.
+	 * @param workers number of workers
+	 * @param worker_fn callable taking the worker id
+	 */
+	template<typename F>
+	void run_on_workers(size_t workers, F &&worker_fn) {
+		if (workers <= 1) {
+			worker_fn(size_t(0));
+			return;
+		}
+		std::vector<std::jthread> threads;
+		threads.reserve(workers - 1);
+		for (size_t worker_id = 1; worker_id < workers; ++worker_id)
+			threads.emplace_back([&worker_fn, worker_id]() { worker_fn(worker_id); });
+		worker_fn(size_t(0));
+		// std::jthread joins on destruction
+	}
+
+}// namespace dice::hypertrie::internal::util
+
+#endif//HYPERTRIE_RUNONWORKERS_HPP
@@ -0,0 +1,113 @@
+#ifndef HYPERTRIE_SMALLKEYSEARCH_HPP
+#define HYPERTRIE_SMALLKEYSEARCH_HPP
+
+/** @file
+ * @brief Lookup of a key in a small contiguous array of keys, as used by the inline storage of HybridMap and HybridSet.
+ * For 8 byte integral keys, the keys are compared with AVX2 (4 per instruction) or SSE4.1 (2 per instruction) if the
+ * target supports it. Otherwise, or if HYPERTRIE_DISABLE_SIMD is defined, a scalar loop is used.
+ * The kernel is selected at compile time.
+ */
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+#if !defined(HYPERTRIE_DISABLE_SIMD) && (defined(__AVX2__) || defined(__SSE4_1__))
+#include <immintrin.h>
+#endif
+
+namespace dice::hypertrie::internal::util {
+
+	enum struct KeySearchKernel {
+		Scalar,
+		SSE4_1,
+		AVX2
+	};
+
+#if !defined(HYPERTRIE_DISABLE_SIMD) && defined(__AVX2__)
+	inline constexpr KeySearchKernel simd_key_search_kernel = KeySearchKernel::AVX2;
+#elif !defined(HYPERTRIE_DISABLE_SIMD) && defined(__SSE4_1__)
+	inline constexpr KeySearchKernel simd_key_search_kernel = KeySearchKernel::SSE4_1;
+#else
+	inline constexpr KeySearchKernel simd_key_search_kernel = KeySearchKernel::Scalar;
+#endif
+
+	/**
+	 * The kernel that is used to find a Key.
+	 */
+	template<typename Key>
+	inline constexpr KeySearchKernel key_search_kernel = (std::is_integral_v<Key> and sizeof(Key) == 8) ? simd_key_search_kernel : KeySearchKernel::Scalar;
+
+	/**
+	 * Number of keys that the kernel for Key compares at once. Arrays passed to find_key() must hold a multiple of it.
+	 */
+	template<typename Key>
+	inline constexpr size_t key_search_lanes = (key_search_kernel<Key> == KeySearchKernel::AVX2)     ? 4
+											   : (key_search_kernel<Key> == KeySearchKernel::SSE4_1) ? 2
+																									 : 1;
+
+	/**
+	 * @return capacity rounded up to a multiple of key_search_lanes<Key>
+	 */
+	template<typename Key>
+	constexpr size_t padded_key_capacity(size_t capacity) noexcept {
+		return (capacity + key_search_lanes<Key> - 1) / key_search_lanes<Key> * key_search_lanes<Key>;
+	}
+
+	/**
+	 * Finds key in keys[0, size) with a scalar loop.
+	 * @return index of key or size if it is not contained
+	 */
+	template<typename Key>
+	size_t find_key_scalar(Key const *keys, size_t size, Key const &key) noexcept {
+		for (size_t i = 0; i < size; ++i)
+			if (keys[i] == key)
+				return i;
+		return size;
+	}
+
+	/**
+	 * Finds key in keys[0, size) with key_search_kernel<Key>.
+	 * Keys behind size are read but ignored. They must be initialized.
+	 * @return index of key or size if it is not contained
+	 */
+	template<typename Key, size_t capacity>
+	size_t find_key(std::array<Key, capacity> const &keys, size_t size, Key const &key) noexcept {
+		static_assert(capacity % key_search_lanes<Key> == 0, "Use padded_key_capacity() to size the array.");
+		[[maybe_unused]] auto const first_match = [size](size_t block_begin, unsigned mask) noexcept -> size_t {
+			// lanes behind size may match as well, but they come after all lanes before size
+			auto const i = block_begin + static_cast<size_t>(std::countr_zero(mask));
+			return (i < size) ? i : size;
+		};
+#if !defined(HYPERTRIE_DISABLE_SIMD) && defined(__AVX2__)
+		if constexpr (key_search_kernel<Key> == KeySearchKernel::AVX2) {
+			auto const needle = _mm256_set1_epi64x(static_cast<long long>(key));
+			for (size_t i = 0; i < size; i += 4) {
+				auto const block = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(keys.data() + i));
+				auto const mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, needle))));
+				if (mask != 0)
+					return first_match(i, mask);
+			}
+			return size;
+		}
+#endif
+#if !defined(HYPERTRIE_DISABLE_SIMD) && (defined(__AVX2__) || defined(__SSE4_1__))
+		if constexpr (key_search_kernel<Key> == KeySearchKernel::SSE4_1) {
+			auto const needle = _mm_set1_epi64x(static_cast<long long>(key));
+			for (size_t i = 0; i < size; i += 2) {
+				auto const block = _mm_loadu_si128(reinterpret_cast<__m128i const *>(keys.data() + i));
+				auto const mask = static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(block, needle))));
+				if (mask != 0)
+					return first_match(i, mask);
+			}
+			return size;
+		}
+#endif
+		if constexpr (key_search_kernel<Key> == KeySearchKernel::Scalar)
+			return find_key_scalar(keys.data(), size, key);
+	}
+
+}// namespace dice::hypertrie::internal::util
+
+#endif//HYPERTRIE_SMALLKEYSEARCH_HPP
@@ -107,6 +107,29 @@ namespace folly_standalone {
 		   return false;
 	   }
 
+	   // copies as many of the count records as fit into the queue. The
+	   // records become visible to the consumer at once.
+	   // Returns the number of records written.
+	   size_t writeBatch(T const* records, size_t count) {
+		   auto const currentWrite = writeIndex_.load(std::memory_order_relaxed);
+		   auto const currentRead = readIndex_.load(std::memory_order_acquire);
+		   size_t const free = (currentRead > currentWrite)
+									   ? currentRead - currentWrite - 1
+									   : size_ - currentWrite + currentRead - 1;
+		   size_t const written = (count < free) ? count : free;
+		   auto nextRecord = currentWrite;
+		   for (size_t i = 0; i < written; ++i) {
+			   new (&records_[nextRecord]) T(records[i]);
+			   if (++nextRecord == size_) {
+				   nextRecord = 0;
+			   }
+		   }
+		   if (written != 0) {
+			   writeIndex_.store(nextRecord, std::memory_order_release);
+		   }
+		   return written;
+	   }
+
 	   // move (or copy) the value at the front of the queue to given variable
 	   bool read(T& record) {
 		   auto const currentRead = readIndex_.load(std::memory_order_relaxed);
@@ -22,9 +22,12 @@ namespace dice::query {
 				 typename value_type_o,
 				 template<typename, typename, typename> class map_type_o,
 				 template<typename, typename> class set_type_o,
-				 ssize_t key_part_tagging_bit_v_o>
-		constexpr auto inject_value_type(Hypertrie_t<key_part_type_o, value_type_o, map_type_o, set_type_o, key_part_tagging_bit_v_o>) {
-			return Hypertrie_t<key_part_type_o, new_value_type, map_type_o, set_type_o, key_part_tagging_bit_v_o>{};
+				 ssize_t key_part_tagging_bit_v_o,
+				 size_t node_storage_shards_v_o,
+				 bool prefetch_lookups_v_o,
+				 size_t max_depth_v_o>
+		constexpr auto inject_value_type(Hypertrie_t<key_part_type_o, value_type_o, map_type_o, set_type_o, key_part_tagging_bit_v_o, node_storage_shards_v_o, prefetch_lookups_v_o, max_depth_v_o>) {
+			return Hypertrie_t<key_part_type_o, new_value_type, map_type_o, set_type_o, key_part_tagging_bit_v_o, node_storage_shards_v_o, prefetch_lookups_v_o, max_depth_v_o>{};
 		}
 
 
@@ -1,9 +1,12 @@
 #ifndef QUERY_CARDINALITYESTIMATION_HPP
 #define QUERY_CARDINALITYESTIMATION_HPP
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 
 #include <boost/container/flat_set.hpp>
+#include <boost/container/small_vector.hpp>
 
 #include "Operator_predeclare.hpp"
 
@@ -77,24 +80,24 @@ namespace dice::query::operators {
 				operands_positions = &odg.operands_with_var_id(var);
 			else
 				operands_positions = &odg.isc_operands_with_var_id(var);
-			std::vector<double> op_dim_cardinalities(operands_positions->size(), 1.0);
-			auto label_count = 0;
+			// the buffers stay on the stack unless the variable occurs in many operands
+			boost::container::small_vector<double, 8> op_dim_cardinalities(operands_positions->size(), 1.0);
+			boost::container::small_vector<size_t, 16> sizes{};
+			std::array<size_t, htt_t::max_depth> op_dim_cards_buffer;
 			auto min_dim_card = std::numeric_limits<size_t>::max();
-			boost::container::flat_set<size_t> sizes{};
 
 			auto const &var_positions = odg.var_ids_positions_in_operands(var);
 			// iterate the operands that hold the label
 			for (size_t i = 0; i < operands_positions->size(); ++i) {
 				auto const &op_pos = (*operands_positions)[i];
 				auto const &operand = operands[op_pos];
-				auto const op_dim_cards = operand.get_cards(var_positions[op_pos]);
-				auto const min_op_dim_card = *std::min_element(op_dim_cards.cbegin(), op_dim_cards.cend());
-				auto const max_op_dim_card = *std::max_element(op_dim_cards.cbegin(), op_dim_cards.cend());
+				auto const op_dim_cards = operand.get_cards(var_positions[op_pos], op_dim_cards_buffer);
+				auto const [min_op_dim_card, max_op_dim_card] = std::ranges::minmax(op_dim_cards);
 
-				for (const auto &op_dim_card : op_dim_cards)
-					sizes.insert(op_dim_card);
+				for (auto const op_dim_card : op_dim_cards)
+					if (std::ranges::find(sizes, op_dim_card) == sizes.end())
+						sizes.push_back(op_dim_card);
 
-				label_count += op_dim_cards.size();
 				// update minimal dimension cardinality
 				if (min_op_dim_card < min_dim_card)
 					min_dim_card = min_op_dim_card;
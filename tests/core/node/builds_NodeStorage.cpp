@@ -6,10 +6,14 @@
 
 #include <cppitertools/itertools.hpp>
 
+#include <set>
+#include <thread>
+
 #include <dice/hypertrie/internal/util/name_of_type.hpp>
 #include <utils/AssetGenerator.hpp>
 #include <utils/Node_test_configs.hpp>
 
+#include <dice/hypertrie/internal/raw/node/AllocateNode.hpp>
 #include <dice/hypertrie/internal/raw/node/Identifier.hpp>
 #include <dice/hypertrie/internal/raw/node/NodeStorage.hpp>
 #include <dice/hypertrie/internal/raw/node/SingleEntryNode.hpp>
@@ -39,10 +43,64 @@ namespace dice::hypertrie::tests::core::node {
 			}
 		}
 
+		TEST_CASE("reuse storage of deleted nodes") {
+			using htt_t = tagged_bool_cfg<3>::htt_t;
+			AllocateNode<3, htt_t, SingleEntryNode, std::allocator<std::byte>> allocate_node{std::allocator<std::byte>()};
+			using node_type = typename decltype(allocate_node)::node_type;
+
+			std::vector<typename decltype(allocate_node)::pointer> node_ptrs;
+			for (size_t i = 0; i < 1'000; ++i)
+				node_ptrs.push_back(allocate_node.new_());
+
+			std::set<node_type *> deleted;
+			for (size_t i = 0; i < node_ptrs.size(); i += 2) {
+				deleted.insert(std::to_address(node_ptrs[i]));
+				allocate_node.delete_(node_ptrs[i]);
+			}
+			for (size_t i = 0; i < deleted.size(); ++i)
+				CHECK(deleted.contains(std::to_address(allocate_node.new_())));
+		}
+
 		TEST_CASE("storage") {
 			NodeStorage<5, tagged_bool_cfg<5>::htt_t, std::allocator<std::byte>> node_storage{std::allocator<std::byte>()};
 		}
 
+		TEST_CASE("sharded storage") {
+			using htt_t = sharded_tagged_bool_cfg<3>::htt_t;
+			using RawIdentifier_t = RawIdentifier<3, htt_t>;
+			using node_storage_type = NodeStorage<3, htt_t, std::allocator<std::byte>>;
+			static_assert(node_storage_type::SpecificNodes<3, FullNode>::is_sharded);
+			node_storage_type node_storage{std::allocator<std::byte>()};
+			auto &nodes = node_storage.template nodes<3, FullNode>().nodes();
+
+			hypertrie::tests::utils::RawGenerator<3, htt_t> gen{};
+			std::vector<RawIdentifier_t> identifiers;
+			for (auto const &key : gen.keys(1'000))
+				identifiers.push_back(RawIdentifier_t{SingleEntry<3, htt_t>{key}});
+
+			// every thread inserts its own share of the identifiers
+			constexpr size_t threads = 4;
+			{
+				std::vector<std::jthread> workers;
+				for (size_t thread_id = 0; thread_id < threads; ++thread_id)
+					workers.emplace_back([&, thread_id]() {
+						for (size_t i = thread_id; i < identifiers.size(); i += threads)
+							nodes.emplace(identifiers[i], nullptr);
+					});
+			}
+
+			CHECK(nodes.size() == identifiers.size());
+			size_t iterated = 0;
+			for (auto it = nodes.begin(); it != nodes.end(); ++it)
+				++iterated;
+			CHECK(iterated == identifiers.size());
+			for (auto const &identifier : identifiers) {
+				CHECK(nodes.contains(identifier));
+				CHECK(node_storage.template lookup<3, FullNode>(identifier) == nullptr);
+			}
+			nodes.clear();
+		}
+
 
 		DOCTEST_TEST_CASE_TEMPLATE("allocate node", T,
 								   bool_cfg<1>, bool_cfg<2>, bool_cfg<3>, bool_cfg<4>, bool_cfg<5>,
@@ -11,6 +11,7 @@
 #include <utils/Node_test_configs.hpp>
 
 #include <dice/hypertrie/internal/raw/node/FullNode.hpp>
+#include <dice/hypertrie/internal/util/SmallKeySearch.hpp>
 
 
 namespace dice::hypertrie::tests::core::node {
@@ -111,5 +112,44 @@ namespace dice::hypertrie::tests::core::node {
 								   double_cfg<1>, double_cfg<2>, double_cfg<3>, double_cfg<4>, double_cfg<5>) {
 			create<T::depth, typename T::htt_t>();
 		}
+
+		TEST_CASE("small edges are promoted") {
+			using htt_t = typename long_cfg<2>::htt_t;
+			using Children_t = typename FullNode<2, htt_t, allocator_type>::ChildrenType;
+
+			Children_t children{allocator_type{}};
+			size_t const count = Children_t::small_capacity + 2;
+			for (size_t i = count; i > 0; --i) {
+				children[i] = RawIdentifier<1, htt_t>{};
+				// inline entries are kept sorted
+				if (children.is_small())
+					REQUIRE(children.begin()->first == i);
+				else
+					REQUIRE(children.size() > Children_t::small_capacity);
+			}
+			REQUIRE(not children.is_small());
+			REQUIRE(children.size() == count);
+			for (size_t i = 1; i <= count; ++i)
+				REQUIRE(children.contains(i));
+
+			for (size_t i = 1; i <= 2; ++i)
+				children.erase(i);
+			Children_t copy{children};
+			REQUIRE(copy.is_small());
+			REQUIRE(copy == children);
+		}
+
+		TEST_CASE("key part search kernel agrees with scalar search") {
+			using key_part_type = unsigned long;
+			MESSAGE("kernel: ", static_cast<int>(key_search_kernel<key_part_type>));
+			std::array<key_part_type, padded_key_capacity<key_part_type>(7)> keys{};
+			for (size_t size = 0; size <= 7; ++size) {
+				// keys behind size must be ignored
+				for (size_t i = 0; i < keys.size(); ++i)
+					keys[i] = (i < size) ? 3 * i + 1 : 4;
+				for (key_part_type key = 0; key < 25; ++key)
+					REQUIRE(find_key(keys, size, key) == find_key_scalar(keys.data(), size, key));
+			}
+		}
 	}
 };// namespace dice::hypertrie::tests::core::node
\ No newline at end of file
@@ -107,6 +107,23 @@ namespace dice::hypertrie::tests::core::node {
 										.removeEntry(entries[3], true) == id0);
 				}
 
+				SUBCASE("precomputed entry hashes") {
+					std::vector<Entry> entries = [&]() {
+						std::vector<Entry> entries;
+						for (auto &&entry : gen.entries(4))
+							entries.push_back(Entry{entry.first, entry.second});
+						return entries;
+					}();
+					std::vector<size_t> entry_hashes;
+					for (auto const &entry : entries)
+						entry_hashes.push_back(RawIdentifier_t::entry_hash(entry));
+
+					for (size_t n = 0; n <= entries.size(); ++n) {
+						std::span<Entry const> const first_n{entries.data(), n};
+						REQUIRE(RawIdentifier_t{first_n, std::span<size_t const>{entry_hashes.data(), n}} == RawIdentifier_t{first_n});
+					}
+				}
+
 				SUBCASE("use default sorting") {
 					std::vector<Entry> entries = [&]() {
 						std::vector<Entry> entries;
@@ -5,6 +5,8 @@
 
 #include <cppitertools/itertools.hpp>
 
+#include <map>
+
 #include <dice/hypertrie/internal/util/fmt_utils.hpp>
 #include <utils/Node_test_configs.hpp>
 #include <utils/RawEntryGenerator.hpp>
@@ -562,5 +564,84 @@ namespace dice::hypertrie::tests::core::node {
 				CHECK(context.get(nc, entry.key()) == entry.value());
 			std::cout << fmt::format("result identifier 1: {}", nc.raw_identifier()) << std::endl;
 		};
+
+		TEST_CASE_TEMPLATE("load entries", T, tagged_bool_cfg<1>, tagged_bool_cfg<3>, bool_cfg<3>, long_cfg<2>, double_cfg<4>) {
+			constexpr auto depth = T::depth;
+			using htt_t = typename T::htt_t;
+			using allocator_type = std::allocator<std::byte>;
+			using key_part_type = typename htt_t::key_part_type;
+			using value_type = typename htt_t::value_type;
+
+			utils::RawEntryGenerator<depth, htt_t> gen{};
+			gen.setKeyPartMinMax(key_part_type(1), key_part_type(8));
+			gen.setValueMinMax(value_type(1), value_type(2));
+
+			for (size_t const count : {1, 2, 5, 50, 300}) {
+				auto const entries = gen.entries(count);
+				decltype(entries) half{entries.begin(), entries.begin() + (entries.size() + 1) / 2};
+
+				RawHypertrieContext<5, htt_t, allocator_type> context{allocator_type{}};
+				NodeContainer<depth, htt_t, allocator_type> nc{};
+				NodeContainer<depth, htt_t, allocator_type> nc_half{};
+				context.load(nc, std::vector{entries});
+				// the nodes of the second hypertrie are already stored
+				context.load(nc_half, std::vector{half});
+
+				ValidationRawNodeContext<5, htt_t, allocator_type> validation_context{allocator_type{}, entries};
+				context.remove(nc_half, std::vector{half});
+				CHECK(validation_context == context);
+				for (const auto &entry : entries)
+					CHECK(context.get(nc, entry.key()) == entry.value());
+			}
+		}
+
+		TEST_CASE_TEMPLATE("set and add values", T, long_cfg<1>, long_cfg<2>, long_cfg<4>) {
+			constexpr auto depth = T::depth;
+			using htt_t = typename T::htt_t;
+			using allocator_type = std::allocator<std::byte>;
+			using key_part_type = typename htt_t::key_part_type;
+			using value_type = typename htt_t::value_type;
+			using SingleEntry_t = SingleEntry<depth, htt_t>;
+
+			utils::RawEntryGenerator<depth, htt_t> gen{};
+			gen.setKeyPartMinMax(key_part_type(1), key_part_type(6));
+			gen.setValueMinMax(value_type(1), value_type(3));
+
+			for (size_t const count : {1, 5, 50, 200}) {
+				auto const before = gen.entries(count);
+				auto const after = gen.entries(count);
+				// removes the keys of before that are not in after and inserts or changes the keys of after
+				std::vector<SingleEntry_t> updates;
+				std::map<RawKey<depth, htt_t>, value_type> deltas;
+				for (auto const &entry : before) {
+					updates.emplace_back(entry.key(), value_type{});
+					deltas[entry.key()] -= entry.value();
+				}
+				for (auto const &entry : after) {
+					updates.push_back(entry);
+					deltas[entry.key()] += entry.value();
+				}
+				ValidationRawNodeContext<5, htt_t, allocator_type> validation_context{allocator_type{}, after};
+
+				SUBCASE("set_values") {
+					RawHypertrieContext<5, htt_t, allocator_type> context{allocator_type{}};
+					NodeContainer<depth, htt_t, allocator_type> nc{};
+					context.insert(nc, std::vector{before});
+					context.set_values(nc, std::move(updates));
+					CHECK(validation_context == context);
+				}
+
+				SUBCASE("add_to_values") {
+					RawHypertrieContext<5, htt_t, allocator_type> context{allocator_type{}};
+					NodeContainer<depth, htt_t, allocator_type> nc{};
+					context.insert(nc, std::vector{before});
+					std::vector<SingleEntry_t> delta_entries;
+					for (auto const &[key, delta] : deltas)
+						delta_entries.emplace_back(key, delta);
+					context.add_to_values(nc, std::move(delta_entries));
+					CHECK(validation_context == context);
+				}
+			}
+		}
 	};
 };// namespace dice::hypertrie::tests::core::node
\ No newline at end of file
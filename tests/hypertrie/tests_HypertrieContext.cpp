@@ -11,6 +11,12 @@
 #include <dice/hypertrie.hpp>
 #include <dice/hypertrie/Hypertrie_default_traits.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+
 
 namespace dice::hypertrie::tests::core::node {
 
@@ -176,5 +182,294 @@ namespace dice::hypertrie::tests::core::node {
 			hyp.set({1, 2, 3}, false);
 			CHECK(hyp.size() == 0);
 		}
+
+		TEST_CASE("lookups with prefetching") {
+			using htt_t = prefetching_tagged_bool_Hypertrie_trait;
+			Hypertrie<htt_t, allocator_type> hypertrie{3};
+			for (size_t i = 1; i <= 200; ++i)
+				hypertrie.set({i % 5 + 1, i % 11 + 1, i}, true);
+
+			for (size_t i = 1; i <= 250; ++i) {
+				CHECK(hypertrie[Key<htt_t>{i % 5 + 1, i % 11 + 1, i}] == (i <= 200));
+				CHECK(hypertrie[Key<htt_t>{i % 5 + 1, i % 3 + 1, i}] == (i <= 200 and i % 3 == i % 11));
+				// each pair of the first two key parts is shared by the 3 or 4 values of i in [1, 200] with the same i % 55
+				auto slice = std::get<0>(hypertrie[SliceKey<htt_t>{i % 5 + 1, i % 11 + 1, std::nullopt}]);
+				CHECK(slice.size() == (i % 55 == 0 or i % 55 > 35 ? 3 : 4));
+			}
+		}
+
+		TEST_CASE("memoize slices") {
+			using htt_t = tagged_bool_Hypertrie_trait;
+			HypertrieContext<htt_t, allocator_type> context{alloc, 4};
+			Hypertrie<htt_t, allocator_type> hypertrie{3, &context};
+			for (size_t i = 1; i <= 200; ++i)
+				hypertrie.set({i % 5 + 1, i % 11 + 1, i}, true);
+			auto slice_size = [&](size_t key_part) {
+				return std::get<0>(hypertrie[SliceKey<htt_t>{key_part, std::nullopt, std::nullopt}]).size();
+			};
+
+			CHECK(slice_size(1) == 40);
+			CHECK(slice_size(1) == 40);
+			CHECK(slice_size(7) == 0);
+			CHECK(slice_size(7) == 0);
+			CHECK(context.slice_cache_stats().hits == 2);
+			CHECK(context.slice_cache_stats().misses == 2);
+
+			// more distinct slices than the cache holds
+			for (size_t key_part = 1; key_part <= 8; ++key_part)
+				CHECK(slice_size(key_part) == (key_part <= 5 ? 40 : 0));
+			CHECK(context.slice_cache_stats().size == 4);
+
+			// a changed hypertrie has a new root, so memoized slices of the old one are not used
+			hypertrie.set({1, 1, 1000}, true);
+			CHECK(slice_size(1) == 41);
+
+			context.clear_slice_cache();
+			CHECK(context.slice_cache_stats().size == 0);
+			CHECK(slice_size(1) == 41);
+		}
+
+		TEST_CASE("copy and move single entry slices") {
+			using htt_t = default_long_Hypertrie_trait;
+			Hypertrie<htt_t, allocator_type> hypertrie{3};
+			hypertrie.set({1, 2, 3}, 5);
+			// the root is a single entry node, so its slices are contextless single entry nodes
+			auto slice = std::get<0>(hypertrie[SliceKey<htt_t>{1, std::nullopt, std::nullopt}]);
+			CHECK(slice[Key<htt_t>{2, 3}] == 5);
+			auto sub_slice = std::get<0>(slice[SliceKey<htt_t>{std::nullopt, 3}]);
+			CHECK(sub_slice[Key<htt_t>{2}] == 5);
+
+			std::vector<const_Hypertrie<htt_t, allocator_type>> slices{slice, slice};
+			slices.push_back(std::move(slice));
+			slices[0] = slices[2];
+			slices[1] = std::move(slices[2]);
+			for (size_t i = 0; i < 2; ++i) {
+				CHECK(slices[i].size() == 1);
+				CHECK(slices[i][Key<htt_t>{2, 3}] == 5);
+				CHECK(slices[i][Key<htt_t>{2, 4}] == 0);
+				for (auto const &entry : slices[i])
+					CHECK(entry.key() == Key<htt_t>{2, 3});
+			}
+		}
+
+		TEST_CASE("look up many keys at once") {
+			using htt_t = default_long_Hypertrie_trait;
+			Hypertrie<htt_t, allocator_type> hypertrie{3};
+			for (size_t i = 1; i <= 200; ++i)
+				hypertrie.set({i % 5 + 1, i % 11 + 1, i}, long(i));
+
+			// contained and not contained keys, many of them with shared key parts
+			std::vector<Key<htt_t>> keys;
+			for (size_t i = 1; i <= 250; ++i) {
+				keys.push_back({i % 5 + 1, i % 11 + 1, i});
+				keys.push_back({i % 5 + 1, i % 3 + 1, i});
+			}
+			std::vector<long> values(keys.size());
+			hypertrie.get_many(keys, values);
+			std::unique_ptr<bool[]> contained{new bool[keys.size()]};
+			hypertrie.contains_many(keys, {contained.get(), keys.size()});
+			for (size_t i = 0; i < keys.size(); ++i) {
+				CHECK(values[i] == hypertrie[keys[i]]);
+				CHECK(contained[i] == (hypertrie[keys[i]] != 0));
+			}
+		}
+
+		TEST_CASE("get cards into a buffer") {
+			using htt_t = default_long_Hypertrie_trait;
+			Hypertrie<htt_t, allocator_type> hypertrie{3};
+			for (size_t i = 1; i <= 200; ++i)
+				hypertrie.set({i % 5 + 1, i % 11 + 1, i}, long(i));
+
+			std::vector<internal::pos_type> const positions{2, 0};
+			std::array<size_t, hypertrie_max_depth> cards_buffer;
+			auto const cards = hypertrie.get_cards(positions, cards_buffer);
+			REQUIRE(cards.size() == 2);
+			CHECK(cards[0] == 200);
+			CHECK(cards[1] == 5);
+			CHECK(hypertrie.get_cards(positions) == std::vector<size_t>{200, 5});
+
+			Hypertrie<htt_t, allocator_type> single_entry{3};
+			single_entry.set({1, 2, 3}, 1);
+			CHECK(std::ranges::equal(single_entry.get_cards(positions, cards_buffer), std::array<size_t, 2>{1, 1}));
+		}
+
+		TEST_CASE("hypertries deeper than the default maximum depth") {
+			using htt_t = Hypertrie_trait<unsigned long,
+										  bool,
+										  internal::container::dice_sparse_map,
+										  internal::container::dice_sparse_set,
+										  63,
+										  1,
+										  false,
+										  7>;
+			Hypertrie<htt_t, allocator_type> hypertrie{7};
+			{
+				BulkInserter<htt_t, allocator_type, BulkUpdaterSyncness::Sync> bulk_inserter{hypertrie, 10};
+				for (size_t i = 1; i <= 50; ++i)
+					bulk_inserter.add(NonZeroEntry<htt_t>{{i % 2 + 1, i % 3 + 1, i % 5 + 1, i % 7 + 1, 1, 2, i}});
+			}
+			hypertrie.set({1, 1, 1, 1, 1, 1, 1}, true);
+			CHECK(hypertrie.size() == 51);
+			CHECK(hypertrie[Key<htt_t>{1, 1, 1, 1, 1, 1, 1}]);
+			CHECK(hypertrie[Key<htt_t>{2, 2, 2, 2, 1, 2, 1}]);
+			CHECK(not hypertrie[Key<htt_t>{2, 2, 2, 2, 1, 2, 2}]);
+
+			auto slice = std::get<0>(hypertrie[SliceKey<htt_t>{std::nullopt, std::nullopt, std::nullopt, std::nullopt, 1, 2, std::nullopt}]);
+			CHECK(slice.depth() == 5);
+			CHECK(slice.size() == 50);
+
+			size_t entries = 0;
+			for ([[maybe_unused]] auto const &entry : hypertrie)
+				++entries;
+			CHECK(entries == 51);
+
+			HashDiagonal<htt_t, allocator_type> hash_diagonal(hypertrie, internal::raw::RawKeyPositions<htt_t::max_depth>{std::initializer_list<size_t>{4, 6}});
+			CHECK(hash_diagonal.find(1));
+			CHECK(not hash_diagonal.find(2));
+		}
+
+		TEST_CASE("read snapshots during bulk insertion") {
+			using htt_t = sharded_tagged_bool_Hypertrie_trait;
+			auto key = [](size_t i) { return Key<htt_t>{i, i % 7 + 1, i % 13 + 1}; };
+			constexpr size_t entries = 20'000;
+
+			HypertrieContext<htt_t, allocator_type> context{alloc};
+			Hypertrie<htt_t, allocator_type> hypertrie{3, &context};
+			SnapshotManager<htt_t, allocator_type> snapshots{context};
+			snapshots.publish(hypertrie);
+
+			std::atomic<bool> done = false;
+			std::atomic<size_t> inconsistent_snapshots = 0;
+			{
+				std::jthread reader{[&]() {
+					while (not done.load()) {
+						// entries are inserted in order, so a snapshot of size n contains exactly the first n keys
+						auto snapshot = snapshots.snapshot(hypertrie);
+						auto const size = snapshot->size();
+						if ((size > 0 and not(*snapshot)[key(size)]) or (*snapshot)[key(size + 1)])
+							++inconsistent_snapshots;
+					}
+				}};
+
+				BulkInserter<htt_t, allocator_type, BulkUpdaterSyncness::Async> bulk_inserter{hypertrie, 1'000, []([[maybe_unused]] auto... args) noexcept {}, 2, &snapshots};
+				for (size_t i = 1; i <= entries; ++i)
+					bulk_inserter.add(NonZeroEntry<htt_t>{key(i)});
+				bulk_inserter.flush();
+				done = true;
+			}
+
+			CHECK(inconsistent_snapshots.load() == 0);
+			CHECK(snapshots.snapshot(hypertrie)->size() == entries);
+			snapshots.unpublish(hypertrie);
+			CHECK(hypertrie.size() == entries);
+		}
+
+		TEST_CASE_TEMPLATE("bulk insertion from multiple producers", syncness_t,
+						   std::integral_constant<BulkUpdaterSyncness, BulkUpdaterSyncness::Sync>,
+						   std::integral_constant<BulkUpdaterSyncness, BulkUpdaterSyncness::Async>) {
+			using htt_t = tagged_bool_Hypertrie_trait;
+			constexpr size_t producers = 4;
+			constexpr size_t entries_per_producer = 5'000;
+			constexpr size_t batch_size = 100;
+
+			Hypertrie<htt_t, allocator_type> hypertrie{3};
+			{
+				BulkInserter<htt_t, allocator_type, syncness_t::value> bulk_inserter{hypertrie, 1'000, []([[maybe_unused]] auto... args) noexcept {}, 1, nullptr, producers};
+				std::vector<std::jthread> threads;
+				for (size_t producer = 0; producer < producers; ++producer) {
+					threads.emplace_back([&, producer]() {
+						// every second producer adds the same entries as its predecessor
+						size_t const offset = (producer / 2) * entries_per_producer;
+						std::vector<NonZeroEntry<htt_t>> batch;
+						for (size_t i = 1; i <= entries_per_producer; ++i) {
+							auto const id = offset + i;
+							NonZeroEntry<htt_t> entry{{id, id % 7 + 1, id % 13 + 1}};
+							if (producer % 2 == 0) {
+								bulk_inserter.add(entry, producer);
+							} else {
+								batch.push_back(entry);
+								if (batch.size() == batch_size or i == entries_per_producer) {
+									bulk_inserter.add_batch(batch, producer);
+									batch.clear();
+								}
+							}
+						}
+					});
+				}
+			}
+			CHECK(hypertrie.size() == (producers / 2) * entries_per_producer);
+		}
+
+		TEST_CASE("bulk updates with entries repeated across bulks") {
+			using htt_t = sharded_tagged_bool_Hypertrie_trait;
+			auto key = [](size_t i) { return Key<htt_t>{i, i % 7 + 1, i % 13 + 1}; };
+			constexpr size_t distinct_entries = 1'000;
+
+			HypertrieContext<htt_t, allocator_type> context{alloc};
+			Hypertrie<htt_t, allocator_type> hypertrie{3, &context};
+			SnapshotManager<htt_t, allocator_type> snapshots{context};
+			for (bool const published : {false, true}) {
+				if (published)
+					snapshots.publish(hypertrie);
+				auto *snapshot_manager = published ? &snapshots : nullptr;
+				// small bulks, so that the same entries are in adjacent bulks
+				{
+					BulkInserter<htt_t, allocator_type, BulkUpdaterSyncness::Async> bulk_inserter{hypertrie, 10, []([[maybe_unused]] auto... args) noexcept {}, 1, snapshot_manager};
+					for (size_t i = 0; i < 10 * distinct_entries; ++i)
+						bulk_inserter.add(NonZeroEntry<htt_t>{key(1 + (i * 7) % distinct_entries)});
+				}
+				CHECK(hypertrie.size() == distinct_entries);
+				{
+					BulkRemover<htt_t, allocator_type, BulkUpdaterSyncness::Async> bulk_remover{hypertrie, 10, []([[maybe_unused]] auto... args) noexcept {}, 1, snapshot_manager};
+					for (size_t i = 0; i < 10 * distinct_entries; ++i)
+						bulk_remover.add(NonZeroEntry<htt_t>{key(1 + (i * 7) % distinct_entries)});
+				}
+				CHECK(hypertrie.size() == 0);
+			}
+			snapshots.unpublish(hypertrie);
+		}
+
+		TEST_CASE("static hypertrie view") {
+			using htt_t = tagged_bool_Hypertrie_trait;
+			using namespace ::dice::hypertrie::internal::raw;
+			Hypertrie<htt_t, allocator_type> hypertrie{3};
+			for (size_t i = 1; i <= 100; ++i)
+				hypertrie.set(Key<htt_t>{i, i % 5 + 1, i % 7 + 1}, true);
+			hypertrie.set(Key<htt_t>{3, 3, 3}, true);
+
+			const_StaticHypertrie<3, htt_t, allocator_type> static_hypertrie{hypertrie};
+			CHECK(static_hypertrie.size() == hypertrie.size());
+			CHECK(static_hypertrie[RawKey<3, htt_t>{3, 3, 3}]);
+			CHECK(not static_hypertrie[RawKey<3, htt_t>{3, 3, 4}]);
+
+			size_t count = 0;
+			for (auto const &entry : static_hypertrie) {
+				auto const &raw_key = entry.key();
+				CHECK(hypertrie[Key<htt_t>{raw_key[0], raw_key[1], raw_key[2]}]);
+				++count;
+			}
+			CHECK(count == hypertrie.size());
+
+			// results with many entries, a single entry and no entry
+			for (size_t key_part : {1, 4, 200}) {
+				SliceKey<htt_t> slice_key{std::nullopt, key_part, std::nullopt};
+				auto const static_slice = static_hypertrie.slice(RawSliceKey<1, htt_t>{slice_key});
+				auto const slice = std::get<0>(hypertrie[slice_key]);
+				CHECK(static_slice.size() == slice.size());
+				CHECK(static_slice.dynamic() == slice);
+			}
+
+			auto diagonal = static_hypertrie.template diagonal<2>(RawKeyPositions<3>{std::vector<uint8_t>{0, 2}});
+			HashDiagonal<htt_t, allocator_type> dynamic_diagonal{hypertrie, RawKeyPositions<htt_t::max_depth>{std::vector<uint8_t>{0, 2}}};
+			CHECK(diagonal.size() == dynamic_diagonal.size());
+			size_t diagonal_count = 0;
+			for (diagonal.begin(); diagonal != diagonal.end(); ++diagonal) {
+				REQUIRE(dynamic_diagonal.find(diagonal.current_key_part()));
+				CHECK(diagonal.current_hypertrie().dynamic() == dynamic_diagonal.current_hypertrie());
+				++diagonal_count;
+			}
+			CHECK(diagonal_count > 0);
+			CHECK(not diagonal.find(200));
+		}
 	};
 };// namespace dice::hypertrie::tests::core::node
\ No newline at end of file
@@ -19,6 +19,9 @@ namespace dice::hypertrie::tests {
 	template<size_t depth>
 	using tagged_bool_cfg = Node_test_config<depth, ::dice::hypertrie::tagged_bool_Hypertrie_trait>;
 
+	template<size_t depth>
+	using sharded_tagged_bool_cfg = Node_test_config<depth, ::dice::hypertrie::sharded_tagged_bool_Hypertrie_trait>;
+
 	template<size_t depth>
 	using long_cfg = Node_test_config<depth, ::dice::hypertrie::default_long_Hypertrie_trait>;
 